@@ -0,0 +1,177 @@
+#include "header.h"
+
+/* function that creates an empty arena */
+Arena *initializeArena()
+{
+    Arena *arena = (Arena *)malloc(sizeof(Arena));
+    if (arena == NULL)
+    {
+        return NULL;
+    }
+
+    arena->pages = NULL;
+    arena->lastPage = NULL;
+    arena->freePages = NULL;
+    arena->lastAllocation = NULL;
+
+    return arena;
+}
+
+/* function that returns the address of the first free byte of a page */
+static char *getPageTop(ArenaPage *page)
+{
+    return (char *)page + ARENA_PAGE_HEADER_SIZE + page->used;
+}
+
+/* function that makes a page with at least a given amount of bytes the current page
+   (a released page is reused if one is big enough). returns FALSE on a memory error */
+static int addPage(Arena *arena, size_t size)
+{
+    ArenaPage **freePage = &arena->freePages;
+    ArenaPage *page;
+
+    /* look for a released page that is big enough */
+    while (*freePage != NULL && (*freePage)->size < size)
+    {
+        freePage = &(*freePage)->next;
+    }
+
+    if (*freePage != NULL)
+    {
+        /* reuse the page */
+        page = *freePage;
+        *freePage = page->next;
+    }
+    else
+    {
+        /* allocate a new page (bigger allocations get a page of their own) */
+        if (size < ARENA_PAGE_SIZE)
+        {
+            size = ARENA_PAGE_SIZE;
+        }
+
+        if ((page = malloc(ARENA_PAGE_HEADER_SIZE + size)) == NULL)
+        {
+            return FALSE; /* memory allocation failed */
+        }
+        page->size = size;
+    }
+
+    page->used = 0;
+
+    /* the new page becomes the current page */
+    page->next = arena->pages;
+    arena->pages = page;
+
+    if (arena->lastPage == NULL)
+    {
+        arena->lastPage = page;
+    }
+
+    return TRUE;
+}
+
+/* function that allocates memory from an arena (returns NULL on a memory error) */
+void *arenaAllocate(Arena *arena, size_t size)
+{
+    char *allocation;
+
+    size = ARENA_ALIGN(size);
+
+    /* ensure the current page has enough space */
+    if (arena->pages == NULL || arena->pages->used + size > arena->pages->size)
+    {
+        if (!addPage(arena, size))
+        {
+            return NULL; /* memory allocation failed */
+        }
+    }
+
+    allocation = getPageTop(arena->pages);
+    arena->pages->used += size;
+
+    arena->lastAllocation = allocation;
+
+    return allocation;
+}
+
+/* function that grows an allocation of an arena, keeping its content (returns NULL on a memory error) */
+void *arenaGrow(Arena *arena, void *allocation, size_t oldSize, size_t newSize)
+{
+    void *newAllocation;
+
+    /* the last allocation can grow in place if the current page has enough space */
+    if (allocation != NULL && allocation == arena->lastAllocation)
+    {
+        ArenaPage *page = arena->pages;
+        size_t offset = (char *)allocation - ((char *)page + ARENA_PAGE_HEADER_SIZE);
+
+        if (offset + ARENA_ALIGN(newSize) <= page->size)
+        {
+            page->used = offset + ARENA_ALIGN(newSize);
+            return allocation;
+        }
+    }
+
+    if ((newAllocation = arenaAllocate(arena, newSize)) == NULL)
+    {
+        return NULL; /* memory allocation failed */
+    }
+
+    /* copy the content (the old allocation is released with the rest of the arena) */
+    if (allocation != NULL)
+    {
+        memcpy(newAllocation, allocation, oldSize);
+    }
+
+    return newAllocation;
+}
+
+/* function that copies a text into an arena (returns the copy, NULL on a memory error) */
+char *arenaCopy(Arena *arena, char *text, int length)
+{
+    char *copy = arenaAllocate(arena, length);
+
+    if (copy != NULL)
+    {
+        memcpy(copy, text, length);
+    }
+
+    return copy;
+}
+
+/* function that releases every allocation of an arena. the pages are moved to the free pages at once
+   (their used size is reset once they are reused) */
+void resetArena(Arena *arena)
+{
+    if (arena->pages != NULL)
+    {
+        arena->lastPage->next = arena->freePages;
+        arena->freePages = arena->pages;
+    }
+
+    arena->pages = NULL;
+    arena->lastPage = NULL;
+    arena->lastAllocation = NULL;
+}
+
+/* function that frees a list of pages */
+static void freePages(ArenaPage *page)
+{
+    while (page)
+    {
+        ArenaPage *temp = page;
+        page = page->next;
+
+        free(temp); /* free the page */
+    }
+}
+
+/* function that frees an arena and all of its pages */
+void freeArena(Arena *arena)
+{
+    freePages(arena->pages);
+    freePages(arena->freePages);
+
+    free(arena);
+}
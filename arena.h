@@ -0,0 +1,52 @@
+/* define a type with the strictest alignment of the allocated data */
+typedef union ArenaAlign
+{
+    long longValue;
+    double doubleValue;
+    void *pointerValue;
+} ArenaAlign;
+
+/* define a page of an arena (its allocations follow the page itself) */
+typedef struct ArenaPage
+{
+    struct ArenaPage *next;
+    size_t size; /* the amount of bytes that can be allocated in the page */
+    size_t used; /* the amount of bytes that were already allocated */
+} ArenaPage;
+
+/* define an arena - a bump allocator for everything that is allocated while assembling a single file.
+   all of its allocations are released at once, and the pages are reused for the next file */
+typedef struct Arena
+{
+    ArenaPage *pages;     /* the pages in use (the current page first) */
+    ArenaPage *lastPage;  /* the oldest page in use */
+    ArenaPage *freePages; /* the released pages, kept for the next file */
+    char *lastAllocation; /* the last allocation (can be grown in place) */
+} Arena;
+
+/* declare a function that creates an empty arena (returns NULL on a memory error) */
+Arena *initializeArena();
+
+/* declare a function that allocates memory from an arena (returns NULL on a memory error) */
+void *arenaAllocate(Arena *, size_t);
+
+/* declare a function that grows an allocation of an arena, keeping its content (returns NULL on a memory error) */
+void *arenaGrow(Arena *, void *, size_t, size_t);
+
+/* declare a function that copies a text into an arena (returns the copy, NULL on a memory error) */
+char *arenaCopy(Arena *, char *, int);
+
+/* declare a function that releases every allocation of an arena (the pages are kept for reuse) */
+void resetArena(Arena *);
+
+/* declare a function that frees an arena and all of its pages */
+void freeArena(Arena *);
+
+/* define the size of a page */
+#define ARENA_PAGE_SIZE 65536
+
+/* define a macro that rounds a size up to the alignment of the allocations */
+#define ARENA_ALIGN(size) (((size) + sizeof(ArenaAlign) - 1) / sizeof(ArenaAlign) * sizeof(ArenaAlign))
+
+/* define the offset of the allocations in a page */
+#define ARENA_PAGE_HEADER_SIZE ARENA_ALIGN(sizeof(ArenaPage))
@@ -1,12 +1,9 @@
 #include "header.h"
 #include "assemble.h"
-
-/* define IC and DC */
-unsigned int IC;
-unsigned int DC;
+#include "keywords.h"
 
 /* assembles the code, calls the first and second transitions */
-int assemble(FILE *fp, char *filename)
+int assemble(LineBuffer *lines, char *filename, AssemblerOptions *options)
 {
     int isError; /* initialize the error flag */
 
@@ -14,45 +11,25 @@ int assemble(FILE *fp, char *filename)
     unsigned int ICF;
     unsigned int DCF;
 
-    SymbolNode *symbolHead = NULL;             /* initialize the head of the symbol table */
-    ExternalWordNode *externalWordHead = NULL; /* initialize the head of the external word table */
-    MemoryQueue *instructionQueue;             /* initialize the instruction queue */
-
-    /* create the memory queues */
-    MemoryQueue *dataQueue = initializeMemoryQueue();
-
-    if (dataQueue == NULL)
-    {
-        /* there were a memory error */
-        handleMemoryError();
-    }
-
-    instructionQueue = initializeMemoryQueue();
+    /* create the context of this file (holds the counters and the tables, allocated with the lines) */
+    AssemblerContext *context = initializeAssemblerContext(lines->arena);
 
-    if (instructionQueue == NULL)
+    if (context == NULL)
     {
         /* there was a memory error */
-        free(dataQueue); /* free the already allocated memory */
         handleMemoryError();
     }
 
-    /* initialize the IC and DC values */
-    IC = INITIAL_IC;
-    DC = INITIAL_DC;
-
-    isError = firstTransition(fp, &symbolHead, dataQueue, instructionQueue, &ICF, &DCF);
+    isError = firstTransition(lines, context, &ICF, &DCF);
 
     if (isError == MEMORY_OVERFLOW)
     {
-        freeMemoryList(instructionQueue);
-        freeMemoryList(dataQueue);
-        freeExternalWordList(&externalWordHead);
-        freeSymbolList(&symbolHead);
+        releaseDataRegions(&context->dataImage);
         return TRUE; /* if there was a memory overflow, skip to the next file (true means an error was found) */
     }
 
     /* check if there was an error on the seconds transition */
-    if (secondTransition(fp, symbolHead, instructionQueue, dataQueue, &externalWordHead))
+    if (secondTransition(context))
     {
         isError = TRUE; /* set the error flag */
     };
@@ -68,73 +45,79 @@ int assemble(FILE *fp, char *filename)
         else
         {
             /* create the files */
-            writeObjectFile(ICF, DCF, filename, instructionQueue->head, dataQueue->head); /* write the object file */
-            writeExternalFile(filename, externalWordHead);                                /* write the external file (if needed) */
-            writeEntryFile(filename, symbolHead);                                         /* write the entry file (if needed) */
+            writeObjectFile(ICF, DCF, filename, &context->instructionImage, &context->dataImage); /* write the object file */
+            if (options->binaryObjectFile)
+            {
+                /* write the binary object file too (with its own tables of the external and entry symbols) */
+                writeBinaryObjectFile(ICF, DCF, filename, context);
+            }
+            writeExternalFile(filename, context->externalWordHead);                               /* write the external file (if needed) */
+            writeEntryFile(filename, context->symbols);                                           /* write the entry file (if needed) */
+            writeRelocationFile(filename, context->relocations, context->relocationsAmount);      /* write the relocation file (if needed) */
         }
     }
 
-    /* free the data */
-    freeMemoryList(instructionQueue);
-    freeMemoryList(dataQueue);
-    freeExternalWordList(&externalWordHead);
-    freeSymbolList(&symbolHead);
+    /* the files of the data regions are unmapped here, the context is released with the arena of the file */
+    releaseDataRegions(&context->dataImage);
 
     return isError;
 }
 
 /* the first transition of the assembler - here is when you get the entire symbol table,
    start coding the codable words and check the findable errors */
-int firstTransition(FILE *fp, SymbolNode **symbolHead, MemoryQueue *dataQueue, MemoryQueue *instructionQueue, unsigned int *ICF, unsigned int *DCF)
+int firstTransition(LineBuffer *lines, AssemblerContext *context, unsigned int *ICF, unsigned int *DCF)
 {
-    char line[MAX_LINE_LENGTH]; /* intialize the line buffer */
-    int lineNum = 0;            /* initialize the line number */
+    char line[SCAN_BUFFER_SIZE]; /* intialize the line buffer (padded with null-terminators for the scanner) */
+    LineMasks masks;             /* initialize the position masks of the line */
+    int lineNum = 0;             /* initialize the line number */
 
     int isError = FALSE; /* initialize the error flag */
 
-    while (fgets(line, MAX_LINE_LENGTH, fp) != NULL)
+    while (lineNum < lines->linesAmount)
     {
-        char *currentLine = line;    /* initialize a pointer to the current character in line */
-        int isEntryDirective;        /* initialize a helper flag */
-        int isExternDirective;       /* initialize a helper flag */
-        int dataOrString;            /* initialize a helper flag */
-        int handleInstructionResult; /* initialize the handleInstruction function result */
+        LineView *lineView = getLine(lines, lineNum); /* get the view of the line */
+        LineTokens tokens;                            /* initialize the token record of the line */
+        int handleInstructionResult;                  /* initialize the handleInstruction function result */
 
-        /* initialize the label (+1 for null-trminator)*/
-        char label[MAX_SYMBOL_LENGTH + 1] = EMPTY_STRING;
+        int firstLineFixup = context->fixupsAmount; /* the first fixup this line might add */
 
-        lineNum++; /* increment the line number */
+        /* copy the line (longer lines were already an error in the pre-assembler) */
+        int lineLength = lineView->length > MAX_LINE_LENGTH ? MAX_LINE_LENGTH : lineView->length;
+        memcpy(line, lineView->start, lineLength);
+        memset(line + lineLength, NULL_TERMINATOR, SCAN_BUFFER_SIZE - lineLength);
 
-        /* skip leading white spaces */
-        skipWhiteSpaces(&currentLine);
+        lineNum++; /* increment the line number */
 
-        /* ensure its not an empty line or a comment line */
-        if (*currentLine == NULL_TERMINATOR || *currentLine == NEW_LINE)
+        /* find the structural characters of the line, then read it into its token record
+           (the errors of the label and the directive are printed by the lexer) */
+        scanLine(line, &masks);
+        if ((tokenizeLine(line, &masks, &tokens, lineNum)) == SYNTAX_ERROR)
         {
+            isError = TRUE; /* set the error flag */
             continue;
         }
 
-        /* check if the line is a label */
-        if ((getLabel(&currentLine, label, lineNum)) == SYNTAX_ERROR)
+        /* ensure its not an empty line */
+        if (tokens.kind == EMPTY_LINE)
         {
-            isError = TRUE; /* set the error flag */
             continue;
         }
 
         /* check if its a directive */
-        if (*currentLine == DOT)
+        if (tokens.kind == DIRECTIVE_LINE)
         {
-            int i;
-
-            if ((dataOrString = isDataOrString(&currentLine)))
+            /* the directives that add data (.data, .string, .fill, .zero and .incbin) */
+            if (tokens.directive != ENTRY_DIRECTIVE_ID && tokens.directive != EXTERN_DIRECTIVE_ID)
             {
+                int codeResult;
+
                 /* check if there is a label */
-                if (strcmp(label, EMPTY_STRING) != 0)
+                if (tokens.label != NULL)
                 {
                     /* if so, ensure its not defined already */
-                    if (isSymbolDefined(*symbolHead, label))
+                    if (isSymbolDefined(context->symbols, tokens.label, tokens.labelLength))
                     {
-                        printErrorInLine(SYMBOL_ALREADY_DEFINED, lineNum, label);
+                        printErrorInLine(SYMBOL_ALREADY_DEFINED, lineNum, tokens.labelLength, tokens.label);
                         isError = TRUE; /* set the error flag */
                         continue;
                     }
@@ -142,99 +125,70 @@ int firstTransition(FILE *fp, SymbolNode **symbolHead, MemoryQueue *dataQueue, M
                     {
                         /* if the label wasn't defined, add the label to the symbol table */
 
-                        if ((addToSymbolTable(symbolHead, label, DC, TYPE_DATA)) == MEMORY_ERROR)
+                        if ((addToSymbolTable(context->symbols, tokens.label, tokens.labelLength, context->DC, TYPE_DATA)) == MEMORY_ERROR)
                         {
-                            customMemoryErrorHandler(fp, symbolHead, instructionQueue, dataQueue, NULL);
+                            handleMemoryError();
                         }
                     }
                 }
 
-                if (dataOrString == DATA_FOUND)
+                /* these functions also handle syntax errors */
+                switch (tokens.directive)
                 {
-                    /* this function also handles syntax errors */
-                    int codeDataResult = codeData(dataQueue, &currentLine, lineNum);
-
-                    switch (codeDataResult)
-                    {
-                    case MEMORY_ERROR:
-                        customMemoryErrorHandler(fp, symbolHead, instructionQueue, dataQueue, NULL);
-                    case SYNTAX_ERROR:
-                        isError = TRUE; /* set the error flag */
-                        break;
-                    case MEMORY_OVERFLOW:
-                        printErrorInLine(MEMORY_OVERFLOW_ERROR, lineNum);
-                        return MEMORY_OVERFLOW; /* return the error code to be handled in the assemble function */
-                    }
+                case DATA_DIRECTIVE_ID:
+                    codeResult = codeData(context, &tokens.arguments, lineNum);
+                    break;
+                case STRING_DIRECTIVE_ID:
+                    codeResult = codeString(context, &tokens.arguments, lineNum);
+                    break;
+                case FILL_DIRECTIVE_ID:
+                case ZERO_DIRECTIVE_ID:
+                    codeResult = codeFill(context, &tokens.arguments, tokens.directive == FILL_DIRECTIVE_ID, lineNum);
+                    break;
+                default:
+                    codeResult = codeIncbin(context, &tokens.arguments, lineNum);
+                    break;
                 }
-                else
-                {
-                    /* this function also handles syntax errors */
-                    int codeStringResult = codeString(dataQueue, &currentLine, lineNum);
 
-                    switch (codeStringResult)
-                    {
-                    case MEMORY_ERROR:
-                        customMemoryErrorHandler(fp, symbolHead, instructionQueue, dataQueue, NULL);
-                    case SYNTAX_ERROR:
-                        isError = TRUE; /* set the error flag */
-                        break;
-                    case MEMORY_OVERFLOW:
-                        printErrorInLine(MEMORY_OVERFLOW_ERROR, lineNum);
-                        return MEMORY_OVERFLOW; /* return the error code to be handled in the assemble function */
-                    }
+                switch (codeResult)
+                {
+                case MEMORY_ERROR:
+                    handleMemoryError();
+                case SYNTAX_ERROR:
+                    isError = TRUE; /* set the error flag */
+                    break;
+                case MEMORY_OVERFLOW:
+                    printErrorInLine(MEMORY_OVERFLOW_ERROR, lineNum);
+                    return MEMORY_OVERFLOW; /* return the error code to be handled in the assemble function */
                 }
 
                 continue;
             }
 
-            isEntryDirective = isEntry(&currentLine);
-            isExternDirective = isExtern(&currentLine);
-
-            if (isEntryDirective || isExternDirective)
+            /* its .entry or .extern (the operand is the label) */
+            if (tokens.directive == ENTRY_DIRECTIVE_ID)
             {
-                /* initialize the operand label (+1 for null-terminator) */
-                char operandLabel[MAX_SYMBOL_LENGTH + 1];
-
-                if (isEntryDirective)
+                /* the entry flag is set once all the symbols are known (in the second transition) */
+                if ((addEntryRequest(context, tokens.operands[0].start, tokens.operands[0].length, lineNum)) == MEMORY_ERROR)
                 {
-                    /* entry would be addressed in the second transition */
-                    continue;
+                    handleMemoryError();
                 }
-
-                /* get operand label for extern */
-                if ((getOperandLabel(&currentLine, operandLabel, lineNum)) != NO_ERROR)
-                {
-                    isError = TRUE; /* set the error flag if an error was found */
-                    continue;
-                }
-
-                /* ensure the symbol doesnt already exist */
-                if (isSymbolDefined(*symbolHead, operandLabel))
-                {
-                    printErrorInLine(SYMBOL_ALREADY_EXISTS_ERROR, lineNum, operandLabel);
-                    isError = TRUE;
-                    continue;
-                }
-
-                /* insert external symbols with the value 0 */
-                if ((addToSymbolTable(symbolHead, operandLabel, 0, TYPE_EXTERNAL)) == MEMORY_ERROR)
-                {
-                    customMemoryErrorHandler(fp, symbolHead, instructionQueue, dataQueue, NULL);
-                }
-
                 continue;
             }
 
-            /* if reached here its an invalid directive name */
-
-            i = 0; /* intialize the length of the word */
-            while (!isspace(currentLine[i]))
+            /* ensure the symbol doesnt already exist */
+            if (isSymbolDefined(context->symbols, tokens.operands[0].start, tokens.operands[0].length))
             {
-                i++;
+                printErrorInLine(SYMBOL_ALREADY_EXISTS_ERROR, lineNum, tokens.operands[0].length, tokens.operands[0].start);
+                isError = TRUE;
+                continue;
             }
 
-            printErrorInLine(INVALID_DIRECTIVE_NAME, lineNum, i, currentLine);
-            isError = TRUE;
+            /* insert external symbols with the value 0 */
+            if ((addToSymbolTable(context->symbols, tokens.operands[0].start, tokens.operands[0].length, 0, TYPE_EXTERNAL)) == MEMORY_ERROR)
+            {
+                handleMemoryError();
+            }
 
             continue;
         }
@@ -242,11 +196,11 @@ int firstTransition(FILE *fp, SymbolNode **symbolHead, MemoryQueue *dataQueue, M
         /* if reached here, its an instruction line */
 
         /* if there is a label, insert it to the symbol table */
-        if (strcmp(label, EMPTY_STRING) != 0)
+        if (tokens.label != NULL)
         {
-            if (isSymbolDefined(*symbolHead, label))
+            if (isSymbolDefined(context->symbols, tokens.label, tokens.labelLength))
             {
-                printErrorInLine(SYMBOL_ALREADY_DEFINED, lineNum, label);
+                printErrorInLine(SYMBOL_ALREADY_DEFINED, lineNum, tokens.labelLength, tokens.label);
                 isError = TRUE; /* set the error flag */
                 continue;
             }
@@ -254,20 +208,20 @@ int firstTransition(FILE *fp, SymbolNode **symbolHead, MemoryQueue *dataQueue, M
             {
                 /* add to the symbol table */
 
-                if ((addToSymbolTable(symbolHead, label, IC, TYPE_CODE)) == MEMORY_ERROR)
+                if ((addToSymbolTable(context->symbols, tokens.label, tokens.labelLength, context->IC, TYPE_CODE)) == MEMORY_ERROR)
                 {
-                    customMemoryErrorHandler(fp, symbolHead, instructionQueue, dataQueue, NULL);
+                    handleMemoryError();
                 }
             }
         }
 
         /* handle the instruction */
-        handleInstructionResult = handleInstruction(&currentLine, instructionQueue, lineNum);
+        handleInstructionResult = handleInstruction(context, &tokens, lineNum);
 
         switch (handleInstructionResult)
         {
         case MEMORY_ERROR:
-            customMemoryErrorHandler(fp, symbolHead, instructionQueue, dataQueue, NULL);
+            handleMemoryError();
         case SYNTAX_ERROR:
             isError = TRUE; /* set the error flag */
             break;
@@ -275,148 +229,83 @@ int firstTransition(FILE *fp, SymbolNode **symbolHead, MemoryQueue *dataQueue, M
             printErrorInLine(MEMORY_OVERFLOW_ERROR, lineNum);
             return MEMORY_OVERFLOW; /* return the error code to be handled in the assemble function */
         }
+
+        /* the symbols of the new fixups point into the line buffer, move them to the same place in the line view */
+        for (; firstLineFixup < context->fixupsAmount; firstLineFixup++)
+        {
+            Fixup *fixup = &context->fixups[firstLineFixup];
+            fixup->symbol = lineView->start + (fixup->symbol - line);
+        }
     }
 
     /* save IC and DC to ICF and DCF (will be used to create output files) */
-    *ICF = IC;
-    *DCF = DC;
+    *ICF = context->IC;
+    *DCF = context->DC;
 
     /* update every data symbol's value by adding ICF */
-    updateDataSymbols(symbolHead, *ICF);
-
-    rewind(fp); /* rewind the file to the beginning */
+    updateDataSymbols(context->symbols, *ICF);
 
     return isError;
 }
 
-/* this is the second transition, it codes the remaning words and checks for the remaining errors */
-int secondTransition(FILE *fp, SymbolNode *symbolHead, MemoryQueue *instructionQueue, MemoryQueue *dataQueue, ExternalWordNode **externalWordHead)
+/* this is the second transition, it codes the words that were left in the fixup table,
+   sets the entry flags and checks for the remaining errors */
+int secondTransition(AssemblerContext *context)
 {
-    char line[MAX_LINE_LENGTH]; /* intialize the line buffer */
-    int lineNum = 0;            /* initialize the line number */
-
     int isError = FALSE; /* initialize the isError flag */
+    int i;               /* initialize an interator */
 
-    MemoryNode *currentInstructionNode = instructionQueue->head; /* initialize the current instruction node */
-    int originalValue;                                           /* initialize the value of the first word in an insturcion */
-    int originalWordsAmount;                                     /* intialize the amount of words in an instruction line */
-
-    while (fgets(line, MAX_LINE_LENGTH, fp) != NULL)
+    /* code the filler words */
+    for (i = 0; i < context->fixupsAmount; i++)
     {
-        char *currentLine = line; /* initialize a pointer to the current character in line */
-
-        int i; /* initialize an interator */
-
-        lineNum++; /* increment the line number */
-
-        /* skip leading white spaces */
-        skipWhiteSpaces(&currentLine);
+        Fixup *fixup = &context->fixups[i];
+        Symbol *symbol = getSymbol(context->symbols, fixup->symbol, fixup->symbolLength); /* get the symbol */
+        int *word = &context->instructionImage.words[fixup->address - INITIAL_IC];        /* get the filler word */
 
-        /* ensure its not an empty line */
-        if (*currentLine == NULL_TERMINATOR || *currentLine == NEW_LINE)
+        if (symbol == NULL)
         {
+            /* the symbol is not defined */
+            printErrorInLine(SYMBOL_DOESNT_EXIST_ERROR, fixup->lineNum, fixup->symbolLength, fixup->symbol);
+            isError = TRUE;
             continue;
         }
 
-        /* skip the label if exists (proccessed in the first transition) */
-        skipLabel(&currentLine);
-
-        /* check if its a directive */
-        if (*currentLine == DOT)
+        /* its either relative or direct addressing method */
+        if (fixup->isRelative)
         {
-            /* check if its a .entry */
-            if (isEntry(&currentLine))
-            {
-                /* initialize the operand label (+1 for null-terminator) */
-                char operandLabel[MAX_SYMBOL_LENGTH + 1] = EMPTY_STRING;
-
-                if ((getOperandLabel(&currentLine, operandLabel, lineNum)) == NO_ERROR)
-                {
-                    /* set the entry flag of that label */
-                    if ((addEntryFlag(symbolHead, operandLabel, lineNum)) == SYNTAX_ERROR)
-                    {
-                        /* error message was already printed in the function */
-                        isError = TRUE; /* set the error flag */
-                    }
-                }
-                else
-                {
-                    isError = TRUE; /* error in the operand label */
-                }
-            }
-
-            continue; /* the rest directive have already been proccessed */
+            fillRelativeAddressingCode(word, symbol, fixup->baseAddress); /* fill the code */
         }
-
-        /* ensure its actually an instruction name (and not an error printed in the first transition) */
-        if (!(isStartWithInstruction(&currentLine)))
+        else
         {
-            isError = TRUE;
-            continue;
+            fillDirectAddressingCode(word, symbol); /* fill the code */
         }
 
-        /* ensure the instruction node actually exists and an error havn't occured in the first transition */
-        if (currentInstructionNode == NULL)
+        /* check if the symbol is type extern */
+        if (strcmp(symbol->type, TYPE_EXTERNAL) == 0)
         {
-            isError = TRUE;
-            continue;
+            /* add the address to the list of external words */
+            if ((addToExternalList(context->arena, &context->externalWordHead, symbol->symbol, fixup->address)) == MEMORY_ERROR)
+            {
+                handleMemoryError();
+            }
         }
-
-        /* if the first operand is a register, skip it to ensure to fill the code to of the second operand (if needed) */
-        if (((currentInstructionNode->code >> SOURCE_ADDRESSING_POS) & REGISTER_ADDRESSING_MASK) == REGISTER_ADDRESSING_MASK)
+        else if (!fixup->isRelative)
         {
-            skipOperand(&currentLine);
+            /* the word holds the address of a symbol of this file (R flag), so it moves with the program */
+            if ((addRelocation(context, fixup->address)) == MEMORY_ERROR)
+            {
+                handleMemoryError();
+            }
         }
+    }
 
-        /* fill the binary code */
-
-        originalValue = currentInstructionNode->value;             /* get the first value */
-        originalWordsAmount = currentInstructionNode->wordsAmount; /* get the amount of words */
-
-        for (i = 0; i < originalWordsAmount && currentInstructionNode != NULL; i++, currentInstructionNode = currentInstructionNode->next)
+    /* set the entry flags */
+    for (i = 0; i < context->entriesAmount; i++)
+    {
+        if ((addEntryFlag(context->symbols, context->entries[i].symbol, context->entries[i].lineNum)) == SYNTAX_ERROR)
         {
-            if (currentInstructionNode->code == CODE_FILLER)
-            {
-                int isRelativeAddressing = *currentLine == AMPERSAND; /* flag if the symbol is used with relative addressing */
-                SymbolNode *symbol;                                   /* initialize the symbol */
-
-                if (isRelativeAddressing)
-                {
-                    /* skip the ampersand */
-                    currentLine++;
-                }
-
-                /* get the symbol */
-                symbol = getOperandSymbol(&currentLine, symbolHead, lineNum);
-                if (symbol == NULL)
-                {
-                    /* the symbol is not defined (error printed in the function) */
-                    isError = TRUE;
-                    continue;
-                }
-
-                /* its either relative or direct addressing method */
-                if (isRelativeAddressing)
-                {
-                    /* relative addressing method */
-                    fillRelativeAddressingCode(currentInstructionNode, symbol, originalValue); /* fill the code */
-                }
-                else
-                {
-                    /* direct addressing method */
-                    fillDirectAddressingCode(currentInstructionNode, symbol); /* fill the code */
-                }
-
-                /* check if the symbol is type extern */
-                if (strcmp(symbol->type, TYPE_EXTERNAL) == 0)
-                {
-                    /* add the address to the list of external words */
-                    if ((addToExternalList(externalWordHead, symbol->symbol, currentInstructionNode->value)) == MEMORY_ERROR)
-                    {
-                        customMemoryErrorHandler(fp, &symbolHead, instructionQueue, dataQueue, externalWordHead);
-                    }
-                }
-            }
+            /* error message was already printed in the function */
+            isError = TRUE; /* set the error flag */
         }
     }
 
@@ -1,139 +1,264 @@
-#define MAX_INSTRUCTION_NAME_LENGTH 5 /* biggest name is "stop" (+1 to get a letter after it) */
 
-/* define the symbol table */
-typedef struct SymbolNode
+/* define a symbol */
+typedef struct Symbol
 {
-   char symbol[MAX_SYMBOL_LENGTH + 1]; /* including the null-terminator */
+   char *symbol;                   /* the interned name (null-terminated) */
+   int length;                     /* the length of the name */
+   unsigned long hash;             /* the hash of the name */
    int value;
    char type[MAX_TYPE_LENGTH + 1]; /* including null-terminator */
    int isEntry;                    /* is entry flag */
-   struct SymbolNode *next;
-} SymbolNode;
+} Symbol;
+
+/* define the symbol table - an open addressing hash table that indexes the symbols in insertion order */
+typedef struct SymbolTable
+{
+   Symbol *symbols;   /* the symbols in insertion order */
+   int symbolsAmount;
+   int symbolsCapacity;
+   int *slots;        /* the hash slots (the index of a symbol + 1, or EMPTY_SLOT) */
+   int slotsCapacity; /* always a power of 2 */
+   Arena *arena;      /* the arena of the symbols and their interned names */
+} SymbolTable;
 
 #define BITS_IN_WORD 24
 
-/* define the memory table */
-typedef struct MemoryNode
-{
-   int value;
-   int code : BITS_IN_WORD;
-   int wordsAmount; /* for instructions (FALSE if its not the first word in an instruction line) */
-   struct MemoryNode *next;
-} MemoryNode;
+/* define the amount of bytes in a word (the bytes of a .incbin file are packed into the words) */
+#define BYTES_IN_WORD 3
 
-typedef struct MemoryQueue
+/* define a region of the data image that is expanded only when the object file is written -
+   a run of a repeated word (.fill, .zero) or the bytes of a file (.incbin, 3 bytes in a word) */
+typedef struct DataRegion
+{
+   int position;     /* the amount of words in the words array that come before the region */
+   int wordsAmount;  /* the amount of words the region takes */
+   int value;        /* the repeated word (of a run) */
+   SourceFile *file; /* the mapped file (NULL for a run) */
+} DataRegion;
+
+/* define a memory image - the words of the code or the data, indexed by their offset from the first address
+   (INITIAL_IC for the code, INITIAL_DC for the data). the regions sit between the words (only in the data) */
+typedef struct MemoryImage
 {
-   MemoryNode *head;
-   MemoryNode *tail;
-} MemoryQueue;
+   int *words; /* the words (only the lower BITS_IN_WORD bits are used) */
+   int wordsAmount;
+   int wordsCapacity;
+   DataRegion *regions; /* the regions, by their position */
+   int regionsAmount;
+   int regionsCapacity;
+} MemoryImage;
+
+/* define a chunk of the records of the object file - formatted by a single thread, straight into the mapped file */
+typedef struct ObjectChunk
+{
+   char *output; /* the place of the first record of the chunk in the file */
+   int first;    /* the index of the first record of the chunk (the code records come before the data records) */
+   int amount;   /* the amount of records in the chunk */
+   int icf;
+   MemoryImage *instructionImage;
+   MemoryImage *dataImage;
+} ObjectChunk;
+
+/* define the least amount of records a formatting thread of the object file takes, and the most threads */
+#define MIN_RECORDS_IN_CHUNK 65536
+#define MAX_FORMATTING_THREADS 16
 
 /* define a node for the external words list (for the .ext output file) */
 typedef struct ExternalWordNode
 {
    int value;
-   char symbol[MAX_SYMBOL_LENGTH + 1]; /* including the null-terminator */
+   char *symbol; /* points to the interned name in the symbol table */
    struct ExternalWordNode *next;
 } ExternalWordNode;
 
-/* define a function that initialized a memory queue */
-MemoryQueue *initializeMemoryQueue();
+/* define a fixup - a word that was left as a filler in the first transition because its symbol
+   wasn't known yet. the fixup table is resolved once the first transition is done */
+typedef struct Fixup
+{
+   int address;        /* the address of the filler word */
+   char *symbol;       /* the symbol name (points into the pre-assembled lines, not null-terminated) */
+   int symbolLength;
+   int isRelative;     /* flag if the symbol is used with relative addressing */
+   int baseAddress;    /* the address of the first word of the instruction */
+   int lineNum;        /* the line of the instruction (for error messages) */
+} Fixup;
+
+/* define an entry request (.entry LABEL), resolved once the first transition is done */
+typedef struct EntryRequest
+{
+   char symbol[MAX_SYMBOL_LENGTH + 1]; /* including the null-terminator */
+   int lineNum;
+} EntryRequest;
+
+/* define the maximum amount of operands in a line */
+#define MAX_OPERANDS 2
+
+/* define an operand token */
+typedef struct Operand
+{
+   char *start;     /* the text of the operand (points into the line, not null-terminated) */
+   int length;
+   int addressing;  /* the addressing method */
+   int value;       /* the register number, or the number of an immediate operand */
+   int valueResult; /* NO_ERROR, or the error found parsing the number of an immediate operand */
+} Operand;
+
+/* define the token record of a line (the lexer reads every line once, and the transitions use the record) */
+typedef struct LineTokens
+{
+   int kind;                       /* EMPTY_LINE, DIRECTIVE_LINE or INSTRUCTION_LINE */
+   char *label;                    /* the label (points into the line, NULL if there is none) */
+   int labelLength;
+   int directive;                  /* the directive id (of a directive line) */
+   char *arguments;                /* the text after the directive (of a directive line) */
+   int mnemonic;                   /* the instruction id (of an instruction line) */
+   Operand operands[MAX_OPERANDS]; /* the operands (the label of .entry and .extern is an operand too) */
+   int operandsAmount;
+   int error;                      /* the error found reading an instruction (NO_ERROR if there is none) */
+} LineTokens;
+
+/* define the assembler context (the state of a single file's assembly, so files can be assembled in parallel) */
+typedef struct AssemblerContext
+{
+   Arena *arena;                       /* the arena of the file (every table is allocated in it) */
+   unsigned int IC;                    /* the instruction counter */
+   unsigned int DC;                    /* the data counter */
+   SymbolTable *symbols;               /* the symbol table */
+   MemoryImage instructionImage;       /* the instructions memory image */
+   MemoryImage dataImage;              /* the data memory image */
+   ExternalWordNode *externalWordHead; /* the head of the external word list */
+   int *relocations;                   /* the addresses of the words that hold an address (the R flag is on), in order */
+   int relocationsAmount;
+   int relocationsCapacity;
+   Fixup *fixups;                      /* the words left to code after the first transition */
+   int fixupsAmount;
+   int fixupsCapacity;
+   EntryRequest *entries;              /* the .entry directives to resolve after the first transition */
+   int entriesAmount;
+   int entriesCapacity;
+} AssemblerContext;
+
+/* declare a function that creates an empty assembler context in an arena (returns NULL on a memory error) */
+AssemblerContext *initializeAssemblerContext(Arena *);
 
 /* declare the first transition function (returns a boolean value if there is an error or not)
    it also gets ICF and DCF */
-int firstTransition(FILE *fp, SymbolNode **, MemoryQueue *, MemoryQueue *, unsigned int *, unsigned int *);
+int firstTransition(LineBuffer *, AssemblerContext *, unsigned int *, unsigned int *);
+
+/* declare the second transition function - resolves the fixup table and the entry requests
+   (returns a boolean value if there is an error or not) */
+int secondTransition(AssemblerContext *);
 
-/* declare the second transition function (returns a boolean value if there is an error or not) */
-int secondTransition(FILE *fp, SymbolNode *, MemoryQueue *, MemoryQueue *, ExternalWordNode **);
+/* declare a function that creates an empty symbol table in an arena (returns NULL on a memory error) */
+SymbolTable *initializeSymbolTable(Arena *);
 
-/* declare a function that checks if a symbol was already defined */
-int isSymbolDefined(SymbolNode *, char *);
+/* declare a function that checks if a symbol with a given length was already defined */
+int isSymbolDefined(SymbolTable *, char *, int);
 
-/* declare a function that adds to the symbol table */
-int addToSymbolTable(SymbolNode **, char *, int, char *);
+/* declare a function that adds to the symbol table (takes the name and its length, the value and the type) */
+int addToSymbolTable(SymbolTable *, char *, int, int, char *);
 
-/* declare a function that gets a label */
-int getLabel(char **, char *, int);
+/* declare a function that reads a scanned line into a token record (returns NO_ERROR or SYNTAX_ERROR) */
+int tokenizeLine(char *, LineMasks *, LineTokens *, int);
 
-/* declare a function that gets operand label */
-int getOperandLabel(char **, char *, int);
+/* declare a function that reads a directive from a position of a scanned line into a token record (returns NO_ERROR or SYNTAX_ERROR) */
+int tokenizeDirective(char *, LineMasks *, int, LineTokens *, int);
 
-/* declare a function that skips the label in the line */
-void skipLabel(char **);
+/* declare a function that reads an instruction from a position of a scanned line into a token record (an error is kept in the record) */
+void tokenizeInstruction(char *, LineMasks *, int, LineTokens *);
 
-/* declare a function that skips an operand */
-void skipOperand(char **);
+/* declare a function that adds an operand with a given length to a token record */
+void addOperand(LineTokens *, char *, int);
+
+/* declare a function that parses a number with a given length */
+int parseNumber(char *, int, int *);
 
 /* declare a function that handles label name error */
 int checkLabelName(char *, int, int);
 
-/* declare a function that checks if a line is a directive (.data or .string) */
-int isDataOrString(char **);
-
-/* declare a function that checks if a line is a directive (.extern) */
-int isExtern(char **);
+/* declare a function that returns a symbol by its name (NULL if it doesn't exist) */
+Symbol *getSymbol(SymbolTable *, char *, int);
 
-/* declare a function that checks if a line is a directive (.entry) */
-int isEntry(char **);
+/* declare a function that adds a filler word to the fixup table
+   (takes the address, the symbol and its length, the relative flag, the address of the instruction and the line number) */
+int addToFixupTable(AssemblerContext *, int, char *, int, int, int, int);
 
-/* declare a function that returns the value of a symbol */
-SymbolNode *getOperandSymbol(char **, SymbolNode *, int);
+/* declare a function that adds an entry request (takes the symbol and its length and the line number) */
+int addEntryRequest(AssemblerContext *, char *, int, int);
 
 /* declare a function that fills relative addressing words (second transition) */
-void fillRelativeAddressingCode(MemoryNode *, SymbolNode *, int);
+void fillRelativeAddressingCode(int *, Symbol *, int);
 
 /* declare a function that fills direct addressing words (second transition) */
-void fillDirectAddressingCode(MemoryNode *, SymbolNode *);
+void fillDirectAddressingCode(int *, Symbol *);
 
 /* declare a function that will add a symbol and add it to the external word list */
-int addToExternalList(ExternalWordNode **, char *, int);
+int addToExternalList(Arena *, ExternalWordNode **, char *, int);
+
+/* declare a function that adds the address of a relocatable word (R flag) to the relocation table */
+int addRelocation(AssemblerContext *, int);
 
 /* declare a function that adds the isEntry flag for a certain symbol */
-int addEntryFlag(SymbolNode *, char *, int);
+int addEntryFlag(SymbolTable *, char *, int);
 
 /* declare a function that updates the value of each data symbol, by adding ICF */
-void updateDataSymbols(SymbolNode **, int);
+void updateDataSymbols(SymbolTable *, int);
+
+/* declare a function that adds a word to a memory image */
+int addToMemoryImage(Arena *, MemoryImage *, int);
 
-/* declare a function that adds to the memory table */
-MemoryNode *addToMemoryTable(MemoryQueue *, int, int);
+/* declare a function that reserves room for some words at the end of a memory image (NULL if the allocation failed) */
+int *reserveMemoryImage(Arena *, MemoryImage *, int);
 
 /* declare a function that codes data (returns the number of data inserted) */
-int codeData(MemoryQueue *, char **, int);
+int codeData(AssemblerContext *, char **, int);
 
 /* declare a function that codes string */
-int codeString(MemoryQueue *, char **, int);
+int codeString(AssemblerContext *, char **, int);
 
-/* declare a function that handles instruction lines */
-int handleInstruction(char **, MemoryQueue *, int);
+/* declare a function that codes a run of a word (.fill count, value - or .zero count when the flag is off) */
+int codeFill(AssemblerContext *, char **, int, int);
 
-/* declare a function that returns the register number of an operand (if it a register) */
-int getRegister(char *);
+/* declare a function that codes the bytes of a file (.incbin "file") */
+int codeIncbin(AssemblerContext *, char **, int);
 
-/* declare a function that checks if a line starts with an instruction */
-int isStartWithInstruction(char **);
+/* declare a function that unmaps the files of the regions of a memory image */
+void releaseDataRegions(MemoryImage *);
 
-/* declare a function that checks if a string with a given length is an instruction name */
-int isInstruction(char *, int);
+/* declare a function that handles instruction lines (takes the token record of the line) */
+int handleInstruction(AssemblerContext *, LineTokens *, int);
 
-/* declare a function that frees the symbol table */
-void freeSymbolList(SymbolNode **);
+/* declare a function that creates the .ob file */
+void writeObjectFile(int, int, char *, MemoryImage *, MemoryImage *);
 
-/* declare a function that frees a memory table (from tail) */
-void freeMemoryList(MemoryQueue *);
+/* declare a function that formats the records of the object file (takes the output, the amount of records, ICF
+   and the images) */
+void formatObjectRecords(char *, int, int, MemoryImage *, MemoryImage *);
 
-/* declare a function that frees the external word list */
-void freeExternalWordList(ExternalWordNode **);
+/* declare a function that formats the records of a chunk of the object file (the routine of a formatting thread) */
+void *formatObjectChunk(void *);
 
-/* declare the custom handle memory allocation error */
-void customMemoryErrorHandler(FILE *, SymbolNode **symbolHead, MemoryQueue *instructionQueue, MemoryQueue *dataQueue, ExternalWordNode **externalWordHead);
+/* declare a function that formats an amount of records of the data image, after skipping some of them
+   (takes the output, the address of the first data record, the image, the skipped amount and the amount) */
+void formatDataRecords(char *, int, MemoryImage *, int, int);
 
-/* declare a function that creates the .ob file */
-void writeObjectFile(int, int, char *, MemoryNode *, MemoryNode *);
+/* declare a function that returns a word of a data region, by its index in the region */
+int getRegionWord(DataRegion *, int);
+
+/* declare a function that creates the binary .obj file (takes ICF, DCF, the filename and the context of the file) */
+void writeBinaryObjectFile(int, int, char *, AssemblerContext *);
+
+/* declare a function that writes the words of the data image to the binary object file (with the regions expanded) */
+void writeBinaryData(OutputWriter *, MemoryImage *);
+
+/* declare a function that creates the .rel file (takes the filename, the relocation table and its length) */
+void writeRelocationFile(char *, int *, int);
 
 /* declare a function that creates the .ext file */
 void writeExternalFile(char *, ExternalWordNode *);
 
 /* declare a function that creates the .ent file */
-void writeEntryFile(char *, SymbolNode *);
+void writeEntryFile(char *, SymbolTable *);
 
 /* define error codes */
 #define SYNTAX_ERROR -1
@@ -147,10 +272,22 @@ void writeEntryFile(char *, SymbolNode *);
 #define MISSING_NUMBER -9
 #define INVALID_CHARACTER -10
 #define MEMORY_OVERFLOW -11
-
-/* define IC and DC as externs */
-extern unsigned int IC;
-extern unsigned int DC;
+#define INVALID_INSTRUCTION -12
+#define CONSECUTIVE_COMMAS -13
+#define INVALID_COMMA -14
+#define EXTRA_CHARACTERS -15
+#define MISSING_OPERAND_COMMA -16
+#define TOO_MANY_DATA_VALUES -17
+#define NUMBER_OUT_OF_RANGE -18
+
+/* define the kinds of lines */
+#define EMPTY_LINE 0
+#define DIRECTIVE_LINE 1
+#define INSTRUCTION_LINE 2
+
+/* define the largest magnitude of a parsed number (of -8388608, the smallest 24 bits number) - the parsing stops
+   after it, before the number overflows */
+#define MAX_NUMBER_MAGNITUDE 8388608
 
 /* define the initial IC and DC values */
 #define INITIAL_IC 100
@@ -158,7 +295,6 @@ extern unsigned int DC;
 
 /* define chars */
 #define DOT '.'
-#define QUOTE_MARK '"'
 #define SEVEN_CHAR '7'
 #define CODE_FILLER '?' /* filler for uncodable words in first transition */
 #define NEGATIVE_SIGN '-'
@@ -166,7 +302,6 @@ extern unsigned int DC;
 #define HASHTAG '#'
 #define ZERO_CHAR '0'
 #define AMPERSAND '&'
-#define COMMENT_CHAR ';'
 
 /* define the maximum line length (including \n or \0) */
 #define MAX_LINE_LENGTH 81
@@ -176,18 +311,8 @@ extern unsigned int DC;
 #define TYPE_EXTERNAL "ex"
 #define TYPE_CODE "co"
 
-/* define the directives */
-#define DATA_DIRECTIVE ".data"
-#define STRING_DIRECTIVE ".string"
-#define ENTRY_DIRECTIVE ".entry"
-#define EXTERN_DIRECTIVE ".extern"
-
-/* define cases for the isDataOrString function (returns the number of data inserted) */
-#define DATA_FOUND 1
-#define STRING_FOUND 2
-
 /* define some error prints */
-#define SYMBOL_ALREADY_DEFINED "Symbol '%s' was already defined. Try a different name"
+#define SYMBOL_ALREADY_DEFINED "Symbol '%.*s' was already defined. Try a different name"
 #define INVALID_INSTRUCTION_NAME "Found an invalid instruction name. Ensure your'e using a valid one"
 #define INVALID_DIRECTIVE_NAME "'%.*s' is not a valid directive. Ensure your'e using a valid one (like .data, .string, .entry or .extern)"
 #define LABEL_TOO_LONG_ERROR "The found label is too long. use a lable with %d characters or less"
@@ -195,14 +320,16 @@ extern unsigned int DC;
 #define SYMBOL_DOESNT_EXIST_ERROR "Found symbol '%.*s' that doesn't exist. Ensure to define it"
 #define LABEL_NOT_START_WITH_LETTER_ERROR "Found invalid label: '%.*s'. Ensure the label starts with a letter"
 #define INVALID_CHARACTER_IN_LABEL_ERROR "Found invalid label: '%.*s'. Ensure the label only contains digits or numbers"
+#define MISSING_WHITE_SPACE_AFTER_COLON "Found a missing whitespace after colon. Ensure to seperate the label name and its definition with a whitespace"
 #define EMPTY_LABEL_ERROR "Found an empty label. Ensure to add the content of it before the ':'"
 #define EXTRA_TEXT_AFTER_LABEL_ERROR "Found extra text after label declaration. Avoid adding an uneccessary characters"
-#define SYMBOL_ALREADY_EXISTS_ERROR "Symbol name '%s' already exists. Try a different name"
+#define SYMBOL_ALREADY_EXISTS_ERROR "Symbol name '%.*s' already exists. Try a different name"
 #define LABEL_IS_INSTRUCTION_ERROR "Instruction '%.*s' can't be used as a label name. Try a different name"
 #define LABEL_IS_REGISTER_ERROR "Found label '%.*s'. register names can't be used as labels. Try a different name"
 #define EXTERNAL_AND_ENTRY_ERROR "Found label: '%s' defined as both external and entry. Ensure to define it as only one"
 #define MACRO_NAME_IS_LABEL_ERROR "Found macro name '%.*s' that is also a label. Ensure to use a different name"
 #define MEMORY_OVERFLOW_ERROR "Memory overflow. Ensure the program is not too big"
+#define OBJECT_FILE_WRITE_ERROR "Couldn't write the object file of: %s\n"
 
 /* define the position of each part of a word (from the right) */
 #define OPCODE_POS 18
@@ -222,8 +349,5 @@ extern unsigned int DC;
 /* define a mask to ensure numbers would be printed in 24 bits */
 #define MASK_24BIT 0xFFFFFF
 
-/* define a macro that checks if a pointer to a char and its length is a register */
-#define IS_REGISTER(str, length) (!(strncmp(str, "r0", length) && strncmp(str, "r1", length) && strncmp(str, "r2", length) && strncmp(str, "r3", length) && strncmp(str, "r4", length) && strncmp(str, "r5", length) && strncmp(str, "r6", length) && strncmp(str, "r7", length)))
-
 /* define the maximum memory size */
 #define MAX_MEMORY_SIZE 2 << 21
\ No newline at end of file
@@ -1,72 +1,14 @@
 #include "header.h"
 #include "assemble.h"
+#include "keywords.h"
 
 /* general assisting functions for the assembler: */
 
-/* function that gets the operand label (e.g. .entry LABEL) */
-int getOperandLabel(char **line, char *operandLabel, int lineNum)
-{
-    /* init variables */
-    int length;
-    char *end = *line;
-
-    /* move to the next space or null-terminator */
-    while (*end != NULL_TERMINATOR && !isspace(*end))
-    {
-        end++;
-    }
-
-    length = end - *line;
-
-    /* ensure the name of the label is valid */
-    if ((checkLabelName(*line, length, lineNum)) == SYNTAX_ERROR)
-    {
-        /* the error message would be printed in the function */
-        return SYNTAX_ERROR;
-    }
-
-    /* get the operand */
-    strncpy(operandLabel, *line, length);
-    operandLabel[length] = NULL_TERMINATOR;
-
-    *line += length; /* skip after the label */
-
-    /* ensure no extranous characters after label declaration */
-    skipWhiteSpaces(line);
-    if (**line != NULL_TERMINATOR)
-    {
-        printErrorInLine(EXTRA_TEXT_AFTER_LABEL_ERROR, lineNum);
-        return SYNTAX_ERROR;
-    }
-
-    return NO_ERROR; /* no errors found */
-}
-
-/* function that checks if a directive is .entry */
-int isEntry(char **line)
-{
-    char *temp;
-    int entryDirectiveLength = strlen(ENTRY_DIRECTIVE);
-
-    if (strncmp(*line, ENTRY_DIRECTIVE, entryDirectiveLength) == 0)
-    {
-        temp = *line + entryDirectiveLength;
-
-        /* ensure no extra characters before the next whitespace */
-        if (isspace(*temp))
-        {
-            *line = temp;
-            skipWhiteSpaces(line);
-            return TRUE;
-        }
-    }
-    return FALSE;
-}
-
 /* function that ensures the label starts with a character and contains only characters and numbers */
 int checkLabelName(char *start, int length, int lineNum)
 {
-    int i; /* initialize the iterator */
+    int i;            /* initialize the iterator */
+    const Keyword *keyword; /* initialize the keyword of the label (if its one) */
 
     /* check for an empty label */
     if (length == 0)
@@ -85,7 +27,7 @@ int checkLabelName(char *start, int length, int lineNum)
     }
 
     /* ensure the first character is a a letter */
-    if (!isalpha(start[0]))
+    if (!IS_LABEL_START(start[0]))
     {
         printErrorInLine(LABEL_NOT_START_WITH_LETTER_ERROR, lineNum, length, start);
         return SYNTAX_ERROR;
@@ -94,22 +36,24 @@ int checkLabelName(char *start, int length, int lineNum)
     /* ensure all characters are digits or numbers */
     for (i = 1; i < length; i++)
     {
-        if (!isalnum(start[i]))
+        if (!IS_LABEL_CHAR(start[i]))
         {
             printErrorInLine(INVALID_CHARACTER_IN_LABEL_ERROR, lineNum, length, start);
             return SYNTAX_ERROR;
         }
     }
 
+    keyword = getKeyword(start, length);
+
     /* ensure its not an instruction name */
-    if (isInstruction(start, length))
+    if (keyword != NULL && keyword->kind == INSTRUCTION_KEYWORD)
     {
         printErrorInLine(LABEL_IS_INSTRUCTION_ERROR, lineNum, length, start);
         return SYNTAX_ERROR;
     }
 
     /* ensure its not a register name */
-    if (IS_REGISTER(start, length))
+    if (keyword != NULL && keyword->kind == REGISTER_KEYWORD)
     {
         printErrorInLine(LABEL_IS_REGISTER_ERROR, lineNum, length, start);
         return SYNTAX_ERROR;
@@ -118,83 +62,115 @@ int checkLabelName(char *start, int length, int lineNum)
     return NO_ERROR; /* no error was found */
 }
 
-/* function that frees the symbol list */
-void freeSymbolList(SymbolNode **head)
+/* function that changes a pointer to point to the first non-white-space character */
+void skipWhiteSpaces(char **line)
 {
-    SymbolNode *current = *head;
-    while (current)
+    while (IS_SPACE(**line))
     {
-        SymbolNode *temp = current;
-        current = current->next;
-
-        free(temp); /* free the node */
+        (*line)++;
     }
 }
 
-/* function that frees a memory list from the tail */
-void freeMemoryList(MemoryQueue *queue)
+/* function that creates an empty assembler context in an arena */
+AssemblerContext *initializeAssemblerContext(Arena *arena)
 {
-    MemoryNode *current = queue->head;
-    MemoryNode *temp;
+    AssemblerContext *context = (AssemblerContext *)arenaAllocate(arena, sizeof(AssemblerContext));
+    if (context == NULL)
+    {
+        return NULL;
+    }
+
+    context->arena = arena;
+
+    /* initialize the IC and DC values */
+    context->IC = INITIAL_IC;
+    context->DC = INITIAL_DC;
+
+    context->externalWordHead = NULL;
+
+    context->relocations = NULL;
+    context->relocationsAmount = 0;
+    context->relocationsCapacity = 0;
 
-    /* free each node */
-    while (current != NULL)
+    context->fixups = NULL;
+    context->fixupsAmount = 0;
+    context->fixupsCapacity = 0;
+
+    context->entries = NULL;
+    context->entriesAmount = 0;
+    context->entriesCapacity = 0;
+
+    /* the memory images start empty (they grow with the first word) */
+    context->instructionImage.words = NULL;
+    context->instructionImage.wordsAmount = 0;
+    context->instructionImage.wordsCapacity = 0;
+    context->instructionImage.regions = NULL;
+    context->instructionImage.regionsAmount = 0;
+    context->instructionImage.regionsCapacity = 0;
+
+    context->dataImage.words = NULL;
+    context->dataImage.wordsAmount = 0;
+    context->dataImage.wordsCapacity = 0;
+    context->dataImage.regions = NULL;
+    context->dataImage.regionsAmount = 0;
+    context->dataImage.regionsCapacity = 0;
+
+    /* create the symbol table */
+    if ((context->symbols = initializeSymbolTable(arena)) == NULL)
     {
-        temp = current;
-        current = current->next;
-        free(temp); /* free the node */
+        return NULL; /* there was a memory error */
     }
 
-    /* finally, free the queue itself */
-    free(queue);
+    return context;
 }
 
-/* function that frees the external word list */
-void freeExternalWordList(ExternalWordNode **head)
+/* function that makes room for one more element in an array that holds a given amount of elements
+   (returns the array, which might have moved, or NULL on a memory error) */
+void *growArray(Arena *arena, void *array, int amount, int *capacity, int elementSize)
 {
-    ExternalWordNode *current = *head;
-    while (current)
-    {
-        ExternalWordNode *temp = current;
-        current = current->next;
+    int newCapacity;
 
-        free(temp); /* free the node */
+    if (amount < *capacity)
+    {
+        return array; /* there is still room */
     }
-}
 
-/* function that initializes a memory queue */
-MemoryQueue *initializeMemoryQueue()
-{
-    MemoryQueue *queue = (MemoryQueue *)malloc(sizeof(MemoryQueue));
-    if (queue == NULL)
+    newCapacity = *capacity == 0 ? INITIAL_TABLE_CAPACITY : *capacity * 2;
+
+    if ((array = arenaGrow(arena, array, *capacity * elementSize, newCapacity * elementSize)) == NULL)
     {
-        return NULL;
+        return NULL; /* memory allocation failed */
     }
-    queue->head = NULL;
-    queue->tail = NULL;
-    return queue;
+
+    *capacity = newCapacity;
+
+    return array;
 }
 
-/* function that changes a pointer to point to the first non-white-space character */
-void skipWhiteSpaces(char **line)
+/* function that returns the hash of a name with a given length (FNV-1a) */
+unsigned long hashName(char *name, int length)
 {
-    while (isspace(**line))
+    unsigned long hash = FNV_OFFSET_BASIS;
+    int i;
+
+    for (i = 0; i < length; i++)
     {
-        (*line)++;
+        hash ^= (unsigned char)name[i];
+        hash = (hash * FNV_PRIME) & HASH_MASK;
     }
+
+    return hash;
 }
 
-/* a function that frees all the data before throwing a memory error */
-void customMemoryErrorHandler(FILE *fp, SymbolNode **symbolHead, MemoryQueue *instructionQueue, MemoryQueue *dataQueue, ExternalWordNode **externalWordHead)
+/* function that allocates the empty slots of a hash table (returns NULL on a memory error) */
+int *allocateSlots(Arena *arena, int slotsCapacity)
 {
-    freeSymbolList(symbolHead);
-
-    freeMemoryList(instructionQueue);
-    freeMemoryList(dataQueue);
-
-    freeExternalWordList(externalWordHead);
+    int *slots = arenaAllocate(arena, slotsCapacity * sizeof(int));
 
-    fclose(fp); /* close the opened file */
+    if (slots != NULL)
+    {
+        memset(slots, EMPTY_SLOT, slotsCapacity * sizeof(int));
+    }
 
-    handleMemoryError();
-}
\ No newline at end of file
+    return slots;
+}
@@ -1,4 +1,5 @@
 #include "header.h"
+#include "workerPool.h"
 
 /*
     This is the assembler project.
@@ -6,86 +7,82 @@
     The assembler is divided into 2 main parts:
     1. Pre-assembler - this part is responsible for palnting the macro definitions where there called, and skipping comment and empty lines.
     2. Assembler - this part is responsible for compiling the assembly file a well as creating the output files.
+    The files are assembled in parallel on a pool of workers (-j N sets the amount, the default is the amount of cores).
+    The pre-assembled code is passed to the assembler in memory. --keep-am also writes it to the pre-assembler (.am) file.
+    --binary-object also writes the object file in a binary format (.obj) that a loader can map, next to the text one (.ob).
 */
 
 int main(int argc, char *argv[])
 {
-    int i;                  /* intilize the index that iterates between the files */
-    int foundError = FALSE; /* initialize the error flag */
-
-    /* ensure at least 1 file was inserted */
-    if (argc == 1)
+    int i;                                         /* intilize the index that iterates between the arguments */
+    int foundError = FALSE;                        /* initialize the error flag */
+    int workersAmount = getDefaultWorkersAmount(); /* initialize the amount of workers */
+    int jobsAmount = 0;                            /* initialize the amount of files */
+    FileJob *jobs = calloc(argc, sizeof(FileJob)); /* initialize the files to assemble */
+    AssemblerOptions options = {FALSE, FALSE};     /* initialize the options */
+
+    if (!jobs)
     {
-        printf("No files were inserted.");
-        return 1;
+        handleMemoryError();
     }
 
-    /* iterate between every file */
+    /* collect the files and the options */
     for (i = 1; i < argc; i++)
     {
-        char *filename = getFileName(argv[i]); /* get the final filename */
-        FILE *file;                            /* open the file */
-        FILE *preAssemblerFile;                /* initialize the preAssembler file */
-
-        /* allocate memory for the new filename with the extension (+ 1 for null-terminator) */
-        char *preAssemblerFileName = malloc(strlen(filename) + strlen(PRE_ASSEMBLER_FILE_EXTENTION) + 1);
-        if (!preAssemblerFileName)
-        {
-            handleMemoryError();
-        }
-
-        /* copy the file name and concatenate the extension */
-        strcpy(preAssemblerFileName, filename);
-        strcat(preAssemblerFileName, PRE_ASSEMBLER_FILE_EXTENTION);
-
-        file = openAssemblyFile(filename); /* open the file */
-
-        if (file == NULL)
+        if (strcmp(argv[i], KEEP_PRE_ASSEMBLER_FILE_OPTION) == 0)
         {
-            printf("An error occured opening the file '%s'.\n", filename);
-            /* an error occured opening the file. was already printed */
-            continue; /* continue to the next file */
+            options.keepPreAssemblerFile = TRUE;
+            continue;
         }
 
-        /* print a message that indicates the start of file scanning */
-        printf("Scanning file '%s'...\n", filename);
-
-        if ((preAssemblerFile = openPreAssemblerFile(preAssemblerFileName)) == NULL)
+        if (strcmp(argv[i], BINARY_OBJECT_FILE_OPTION) == 0)
         {
-            printf("An error occured opening the pre-assembler file '%s'\n.", filename);
-            /* an error occured opening the pre-assembler file. was already printed */
-            continue; /* continue to the next file */
+            options.binaryObjectFile = TRUE;
+            continue;
         }
 
-        /* pre-assemble the file */
-        if ((foundError = preAssembler(file, preAssemblerFile)) == FALSE)
-        {
-            foundError = assemble(preAssemblerFile, filename); /* assemble the file */
-
-            fclose(preAssemblerFile); /* close the pre-assembler file */
-        }
-        else
+        if (strncmp(argv[i], JOBS_OPTION, JOBS_OPTION_LENGTH) == 0)
         {
-            fclose(preAssemblerFile); /* close the pre-assembler file */
-
-            /* an error occured - remove the pre-assembler file */
-
-            printf("An error occured pre-assembling the file.\n");
+            char *amount = argv[i] + JOBS_OPTION_LENGTH; /* the amount can be attached (-j4) */
+            char *end;
 
-            if (remove(preAssemblerFileName) == 0)
+            if (*amount == NULL_TERMINATOR && i + 1 < argc)
             {
-                printf("Pre-assembled file was successfully removed.\n");
+                amount = argv[++i]; /* or be the next argument (-j 4) */
             }
-            else
+
+            workersAmount = (int)strtol(amount, &end, 10);
+            if (*amount == NULL_TERMINATOR || *end != NULL_TERMINATOR || workersAmount <= 0)
             {
-                printf("Failed to remove the pre-assembled file.\n");
+                printError(INVALID_JOBS_AMOUNT_ERROR, amount);
+                free(jobs);
+                return 1;
             }
+            continue;
         }
 
-        free(preAssemblerFileName); /* free the pre-assembler file name */
-        fclose(file);               /* close the source file */
+        jobs[jobsAmount++].filename = argv[i];
+    }
+
+    /* ensure at least 1 file was inserted */
+    if (jobsAmount == 0)
+    {
+        printf("No files were inserted.");
+        free(jobs);
+        return 1;
     }
 
+    /* choose the scanner of the lines once, before the workers start */
+    initializeScanner();
+    initializeIncludeCache();
+
+    /* assemble every file */
+    foundError = runWorkerPool(jobs, jobsAmount, workersAmount, &options);
+
+    releaseIncludeCache(); /* the included files are shared by every file, so they are released last */
+
+    free(jobs);
+
     /* print a concluding message */
     if (foundError)
     {
@@ -98,3 +95,86 @@ int main(int argc, char *argv[])
 
     return 0;
 }
+
+/* pre-assembles, assembles and writes the output files of a single file (returns TRUE if an error was found).
+   everything the file needs is allocated in the arena, which is released once the file is done */
+int assembleFile(char *argument, AssemblerOptions *options, Arena *arena)
+{
+    char *filename = getFileName(argument); /* get the final filename */
+    SourceFile *source;                     /* initialize the mapped source file */
+    LineBuffer *preAssembledLines;          /* initialize the pre-assembled lines */
+    int foundError;                         /* initialize the error flag */
+
+    if (filename == NULL)
+    {
+        return TRUE; /* not an assembly file (error was already printed) */
+    }
+
+    source = mapAssemblyFile(filename); /* open the file */
+
+    if (source == NULL)
+    {
+        fprintf(getMessageStream(), "An error occured opening the file '%s'.\n", filename);
+        /* an error occured opening the file. was already printed */
+        return TRUE;
+    }
+
+    /* print a message that indicates the start of file scanning */
+    fprintf(getMessageStream(), "Scanning file '%s'...\n", filename);
+
+    if ((preAssembledLines = initializeLineBuffer(arena)) == NULL)
+    {
+        unmapSourceFile(source);
+        handleMemoryError();
+    }
+
+    /* pre-assemble the file (the lines point into the source, so it stays mapped until the file is assembled) */
+    if ((foundError = preAssembler(source, filename, preAssembledLines)) == FALSE)
+    {
+        if (options->keepPreAssemblerFile)
+        {
+            writePreAssemblerFile(filename, preAssembledLines); /* write the .am file */
+        }
+
+        foundError = assemble(preAssembledLines, filename, options); /* assemble the file */
+    }
+    else
+    {
+        fprintf(getMessageStream(), "An error occured pre-assembling the file.\n");
+    }
+
+    resetArena(arena);       /* release everything that was allocated for the file */
+    unmapSourceFile(source); /* unmap the source file */
+
+    return foundError;
+}
+
+/* writes the pre-assembled lines to the pre-assembler (.am) file */
+void writePreAssemblerFile(char *filename, LineBuffer *preAssembledLines)
+{
+    FILE *preAssemblerFile; /* initialize the preAssembler file */
+
+    /* allocate memory for the new filename with the extension (+ 1 for null-terminator) */
+    char *preAssemblerFileName = malloc(strlen(filename) + strlen(PRE_ASSEMBLER_FILE_EXTENTION) + 1);
+    if (!preAssemblerFileName)
+    {
+        handleMemoryError();
+    }
+
+    /* copy the file name and concatenate the extension */
+    strcpy(preAssemblerFileName, filename);
+    strcat(preAssemblerFileName, PRE_ASSEMBLER_FILE_EXTENTION);
+
+    if ((preAssemblerFile = openPreAssemblerFile(preAssemblerFileName)) == NULL)
+    {
+        fprintf(getMessageStream(), "An error occured opening the pre-assembler file '%s'\n.", filename);
+        /* an error occured opening the pre-assembler file. was already printed */
+        free(preAssemblerFileName);
+        return;
+    }
+
+    writeLineBuffer(preAssembledLines, preAssemblerFile);
+
+    fclose(preAssemblerFile);   /* close the pre-assembler file */
+    free(preAssemblerFileName); /* free the pre-assembler file name */
+}
@@ -0,0 +1,45 @@
+/* the binary object file (.obj) - the same content as the text object file with the entry and external files,
+   laid out to be mapped and used in place by a loader. every number is little-endian.
+
+   the header          BINARY_HEADER_SIZE bytes: the magic, then BINARY_HEADER_FIELDS numbers of 4 bytes each
+   the code section    the words of the code, BYTES_IN_WORD bytes each (at the code offset)
+   the data section    the words of the data, right after the code (at the data offset)
+   the externals table a record for each use of an external symbol (at a 4 bytes aligned offset)
+   the entries table   a record for each entry symbol
+   the relocations     the address of every word that holds an address of this file (R flag), 4 bytes each, in order
+   the names           the names of the symbols of the tables, each ends with a null-terminator
+
+   a record of a table is 2 numbers of 4 bytes: the offset of its name in the names, and its address.
+   moving the program by a distance adds the distance to the address in the bits 3-23 of every relocated word */
+
+/* define the magic of the file (the first bytes of it) */
+#define BINARY_MAGIC "AOBJ"
+#define BINARY_MAGIC_LENGTH 4
+
+/* define the version of the layout (changes whenever the layout does) */
+#define BINARY_VERSION 2
+
+/* define the indexes of the numbers of the header (after the magic) */
+#define BINARY_VERSION_FIELD 0
+#define BINARY_ICF_FIELD 1               /* the final IC (the address after the code) */
+#define BINARY_DCF_FIELD 2               /* the final DC (the amount of data words) */
+#define BINARY_CODE_ADDRESS_FIELD 3      /* the address of the first code word (INITIAL_IC) */
+#define BINARY_CODE_OFFSET_FIELD 4
+#define BINARY_DATA_OFFSET_FIELD 5
+#define BINARY_EXTERNALS_OFFSET_FIELD 6
+#define BINARY_EXTERNALS_AMOUNT_FIELD 7
+#define BINARY_ENTRIES_OFFSET_FIELD 8
+#define BINARY_ENTRIES_AMOUNT_FIELD 9
+#define BINARY_NAMES_OFFSET_FIELD 10
+#define BINARY_NAMES_SIZE_FIELD 11
+#define BINARY_RELOCATIONS_OFFSET_FIELD 12
+#define BINARY_RELOCATIONS_AMOUNT_FIELD 13
+#define BINARY_HEADER_FIELDS 14
+
+/* define the sizes of the parts of the file (in bytes) */
+#define BINARY_NUMBER_SIZE 4
+#define BINARY_HEADER_SIZE (BINARY_MAGIC_LENGTH + BINARY_HEADER_FIELDS * BINARY_NUMBER_SIZE)
+#define BINARY_RECORD_SIZE (2 * BINARY_NUMBER_SIZE)
+
+/* define a macro that aligns an offset of the file to the size of a number */
+#define ALIGN_TO_NUMBER(offset) (((offset) + BINARY_NUMBER_SIZE - 1) & ~(BINARY_NUMBER_SIZE - 1))
@@ -0,0 +1,26 @@
+#include "header.h"
+
+/* the character classes of the lexer: a single lookup replaces the calls to isspace, isalpha, isalnum and isdigit,
+   which depend on the locale and are undefined for negative chars */
+
+#define EN CHAR_END
+#define SP CHAR_SPACE
+#define AL (CHAR_LABEL_START | CHAR_LABEL | CHAR_NAME)
+#define DG (CHAR_DIGIT | CHAR_LABEL | CHAR_NAME)
+#define US CHAR_NAME
+#define SG CHAR_SIGN
+#define CM CHAR_COMMA
+#define QT CHAR_QUOTE
+#define CL CHAR_COLON
+#define CO CHAR_COMMENT
+
+/* the classes of the ASCII characters (the bytes 128-255 are in no class) */
+const unsigned short characterClasses[256] = {
+    EN,  0,  0,  0,  0,  0,  0,  0,  0, SP, SP, SP, SP, SP,  0,  0,
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    SP,  0, QT,  0,  0,  0,  0,  0,  0,  0,  0, SG, CM, SG,  0,  0,
+    DG, DG, DG, DG, DG, DG, DG, DG, DG, DG, CL, CO,  0,  0,  0,  0,
+     0, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL,
+    AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL,  0,  0,  0,  0, US,
+     0, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL,
+    AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL,  0,  0,  0,  0,  0};
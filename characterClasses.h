@@ -0,0 +1,32 @@
+/* define the classes of a character (a character can be in several of them) */
+#define CHAR_END 0x001         /* the null-terminator */
+#define CHAR_SPACE 0x002       /* a white space (' ', '\t', '\n', '\v', '\f' or '\r') */
+#define CHAR_LABEL_START 0x004 /* a letter (a label or a macro name starts with one) */
+#define CHAR_LABEL 0x008       /* a letter or a digit (the rest of a label) */
+#define CHAR_NAME 0x010        /* a letter, a digit or an underscore (the rest of a macro name or parameter) */
+#define CHAR_DIGIT 0x020       /* a decimal digit */
+#define CHAR_SIGN 0x040        /* a sign of a number ('+' or '-') */
+#define CHAR_COMMA 0x080       /* a comma */
+#define CHAR_QUOTE 0x100       /* a quote mark */
+#define CHAR_COLON 0x200       /* a colon */
+#define CHAR_COMMENT 0x400     /* the start of a comment */
+
+/* declare the class table (256 entries, one for each byte - the classes don't depend on the locale) */
+extern const unsigned short characterClasses[];
+
+/* define a macro that returns the classes of a character (it can be a negative char) */
+#define CHARACTER_CLASS(c) (characterClasses[(unsigned char)(c)])
+
+/* define the macros that check the class of a character */
+#define IS_SPACE(c) (CHARACTER_CLASS(c) & CHAR_SPACE)
+#define IS_WORD_END(c) (CHARACTER_CLASS(c) & (CHAR_SPACE | CHAR_END))
+#define IS_LABEL_START(c) (CHARACTER_CLASS(c) & CHAR_LABEL_START)
+#define IS_LABEL_CHAR(c) (CHARACTER_CLASS(c) & CHAR_LABEL)
+#define IS_NAME_CHAR(c) (CHARACTER_CLASS(c) & CHAR_NAME)
+#define IS_OPERAND_END(c) (CHARACTER_CLASS(c) & (CHAR_SPACE | CHAR_END | CHAR_COMMA))
+#define IS_DIGIT(c) (CHARACTER_CLASS(c) & CHAR_DIGIT)
+#define IS_NUMBER_START(c) (CHARACTER_CLASS(c) & (CHAR_DIGIT | CHAR_SIGN))
+#define IS_COMMA(c) (CHARACTER_CLASS(c) & CHAR_COMMA)
+#define IS_QUOTE(c) (CHARACTER_CLASS(c) & CHAR_QUOTE)
+#define IS_COLON(c) (CHARACTER_CLASS(c) & CHAR_COLON)
+#define IS_COMMENT(c) (CHARACTER_CLASS(c) & CHAR_COMMENT)
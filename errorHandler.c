@@ -1,4 +1,33 @@
 #include "header.h"
+#include <pthread.h>
+
+/* the key of the per-thread message stream (so parallel files dont mix their messages) */
+static pthread_key_t messageStreamKey;
+static pthread_once_t messageStreamKeyOnce = PTHREAD_ONCE_INIT;
+
+/* creates the message stream key (called once) */
+static void createMessageStreamKey()
+{
+    pthread_key_create(&messageStreamKey, NULL);
+}
+
+/* sets the stream the messages of the current thread are printed to (NULL for stdout) */
+void setMessageStream(FILE *stream)
+{
+    pthread_once(&messageStreamKeyOnce, createMessageStreamKey);
+    pthread_setspecific(messageStreamKey, stream);
+}
+
+/* returns the stream the messages of the current thread are printed to */
+FILE *getMessageStream()
+{
+    FILE *stream;
+
+    pthread_once(&messageStreamKeyOnce, createMessageStreamKey);
+    stream = (FILE *)pthread_getspecific(messageStreamKey);
+
+    return stream != NULL ? stream : stdout;
+}
 
 /* prints an error given a format and arguments */
 void printError(char *format, ...)
@@ -8,9 +37,9 @@ void printError(char *format, ...)
     va_start(args, format);
 
     /* print the provided error message with the arguments */
-    fprintf(stdout, "Error: ");
-    vfprintf(stdout, format, args);
-    fprintf(stdout, ".\n");
+    fprintf(getMessageStream(), "Error: ");
+    vfprintf(getMessageStream(), format, args);
+    fprintf(getMessageStream(), ".\n");
 
     va_end(args);
 }
@@ -23,9 +52,9 @@ void printErrorInLine(char *format, int lineNum, ...)
     va_start(args, lineNum);
 
     /* print the provided error message with the arguments */
-    fprintf(stdout, "Error in line %d: ", lineNum);
-    vfprintf(stdout, format, args);
-    fprintf(stdout, ".\n");
+    fprintf(getMessageStream(), "Error in line %d: ", lineNum);
+    vfprintf(getMessageStream(), format, args);
+    fprintf(getMessageStream(), ".\n");
 
     va_end(args);
 }
@@ -33,6 +62,7 @@ void printErrorInLine(char *format, int lineNum, ...)
 /* function that prints and throws a memory error */
 void handleMemoryError()
 {
+    setMessageStream(NULL); /* the process exits, so print straight to stdout */
     printError("Memory allocation failed.\n");
     exit(EXIT_FAILURE);
 }
\ No newline at end of file
@@ -1,5 +1,11 @@
 #include "header.h"
 #include "fileHandler.h"
+#include <errno.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 /* returns the final filename */
 char *getFileName(char *filename)
@@ -20,10 +26,10 @@ char *getFileName(char *filename)
     return filename;
 }
 
-/* opens a file and ensures its assembly */
-FILE *openAssemblyFile(char *filename)
+/* maps an assembly file to memory (returns NULL if it couldn't be opened) */
+SourceFile *mapAssemblyFile(char *filename)
 {
-    FILE *file;
+    SourceFile *source;
 
     /* allocate memory for the new filename with the extension (+ 1 for null-terminator) */
     char *finalFilename = malloc(strlen(filename) + strlen(ASSEMBLY_FILE_EXTENTION) + 1);
@@ -37,120 +43,297 @@ FILE *openAssemblyFile(char *filename)
     strcat(finalFilename, ASSEMBLY_FILE_EXTENTION);
 
     /* open the file */
-    file = fopen(finalFilename, READ);
-    if (file == NULL)
+    if ((source = mapFile(finalFilename)) == NULL)
     {
         printError("Couldn't open file: %s\n", finalFilename);
-        free(finalFilename);
-        return NULL; /* indicate an error */
     }
 
     free(finalFilename);
 
-    return file; /* return the file pointer */
+    return source; /* return the mapped file */
+}
+
+/* maps a file to memory, by its path (returns NULL if it couldn't be opened) */
+SourceFile *mapFile(char *path)
+{
+    SourceFile *source;
+    struct stat fileStatus;
+    int fd;
+
+    /* open the file */
+    fd = open(path, O_RDONLY);
+    if (fd == -1 || fstat(fd, &fileStatus) == -1 || fileStatus.st_size > INT_MAX) /* the size is kept in an int */
+    {
+        if (fd != -1)
+        {
+            close(fd);
+        }
+        return NULL; /* indicate an error */
+    }
+
+    if ((source = malloc(sizeof(SourceFile))) == NULL)
+    {
+        close(fd);
+        handleMemoryError();
+    }
+
+    source->size = (int)fileStatus.st_size;
+    source->data = NULL; /* an empty file has nothing to map */
+
+    if (source->size > 0)
+    {
+        source->data = mmap(NULL, source->size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (source->data == MAP_FAILED)
+        {
+            close(fd);
+            free(source);
+            return NULL; /* indicate an error */
+        }
+    }
+
+    close(fd); /* the mapping stays valid after closing */
+
+    return source; /* return the mapped file */
+}
+
+/* returns the size of a file in bytes, by its path (-1 if it couldn't be found) */
+long getFileSize(char *path)
+{
+    struct stat fileStatus;
+
+    if (stat(path, &fileStatus) == -1)
+    {
+        return -1; /* indicate an error */
+    }
+
+    return (long)fileStatus.st_size;
+}
+
+/* unmaps a source file */
+void unmapSourceFile(SourceFile *source)
+{
+    if (source->data != NULL)
+    {
+        munmap(source->data, source->size);
+    }
+    free(source);
+}
+
+/* reads the line that starts at a given offset of the source (returns FALSE if there are no more lines) */
+int readSourceLine(SourceFile *source, int *offset, LineView *line)
+{
+    char *newLine;
+    int remaining = source->size - *offset;
+
+    if (remaining <= 0)
+    {
+        return FALSE; /* reached the end of the file */
+    }
+
+    line->start = source->data + *offset;
+
+    /* the line ends after the new-line, or at the end of the file */
+    newLine = memchr(line->start, NEW_LINE, remaining);
+    line->length = newLine != NULL ? newLine - line->start + 1 : remaining;
+
+    *offset += line->length;
+
+    return TRUE;
 }
 
 /* opens / creates the preAssembler file */
 FILE *openPreAssemblerFile(char *finalFilename)
 {
     /* open the file */
-    FILE *preAssemblerFile = fopen(finalFilename, WRITE_AND_READ);
+    FILE *preAssemblerFile = fopen(finalFilename, WRITE);
     if (preAssemblerFile == NULL)
     {
         printError("Couldn't create file: %s\n", finalFilename);
-        free(finalFilename);
         return NULL; /* indicate an error */
     }
 
     return preAssemblerFile; /* return the file pointer */
 }
 
-/* opens / creates the object file */
-FILE *openObjectFile(char *filename)
-{
-    FILE *objectFile;
+/* the output files: a file is replaced only if its content changes, so an unchanged file keeps its time stamp.
+   the new content is written to a temporary file next to it, which is renamed over it once its complete */
 
+/* prepares an output file by its name and extension (nothing is created until there is content to write) */
+void openOutputFile(OutputFile *file, char *filename, char *extension)
+{
     /* allocate memory for the new filename with the extension (+ 1 for null-terminator) */
-    char *finalFilename = malloc(strlen(filename) + strlen(OBJECT_FILE_EXTENSION) + 1);
-    if (!finalFilename)
+    file->path = malloc(strlen(filename) + strlen(extension) + 1);
+    if (!file->path)
     {
         handleMemoryError();
     }
 
     /* copy the file name and concatenate the extension */
-    strcpy(finalFilename, filename);
-    strcat(finalFilename, OBJECT_FILE_EXTENSION);
+    strcpy(file->path, filename);
+    strcat(file->path, extension);
 
-    /* open the file */
-    objectFile = fopen(finalFilename, WRITE);
-    if (objectFile == NULL)
+    file->tempPath = NULL;
+    file->fd = -1;
+
+    /* the content of the existing file is compared with the new one (NULL if there is no such file) */
+    file->existing = mapFile(file->path);
+}
+
+/* creates the temporary file of an output file (returns FALSE on an error) */
+static int createTempFile(OutputFile *file)
+{
+    int attempt;
+
+    /* allocate memory for the temporary filename (the file name, 2 numbers, 2 dots and the extension) */
+    file->tempPath = malloc(strlen(file->path) + 2 * MAX_NUMBER_DIGITS + strlen(TEMP_FILE_EXTENSION) + 3);
+    if (!file->tempPath)
     {
-        printError("Couldn't open file: %s\n", finalFilename);
-        free(finalFilename);
-        return NULL; /* indicate an error */
+        handleMemoryError();
     }
 
-    free(finalFilename);
+    /* the name is unique to the process, and a name that is taken (by another worker) is skipped */
+    for (attempt = 0; attempt < MAX_TEMP_FILE_ATTEMPTS; attempt++)
+    {
+        sprintf(file->tempPath, "%s.%ld.%d%s", file->path, (long)getpid(), attempt, TEMP_FILE_EXTENSION);
+
+        file->fd = open(file->tempPath, O_RDWR | O_CREAT | O_EXCL, OUTPUT_FILE_MODE);
+        if (file->fd != -1 || errno != EEXIST)
+        {
+            break;
+        }
+    }
+
+    if (file->fd == -1)
+    {
+        printError("Couldn't open file: %s\n", file->path);
+        free(file->tempPath);
+        file->tempPath = NULL;
+        return FALSE; /* indicate an error */
+    }
+
+    return TRUE;
+}
 
-    return objectFile; /* return the file pointer */
+/* checks if the content of an output file is the same as the content of the existing file */
+int isOutputUnchanged(OutputFile *file, char *data, int size)
+{
+    return file->existing != NULL && file->existing->size == size && memcmp(file->existing->data, data, size) == 0;
 }
 
-/* opens / creates the external file */
-FILE *openExternFile(char *filename)
+/* writes to the temporary file of an output file, creates it on the first write (returns FALSE on an error) */
+int writeOutputFile(OutputFile *file, char *data, int size)
 {
-    FILE *externFile;
+    int written = 0;
 
-    /* allocate memory for the new filename with the extension (+ 1 for null-terminator) */
-    char *finalFilename = malloc(strlen(filename) + strlen(EXTERNAL_FILE_EXTENSTION) + 1);
-    if (!finalFilename)
+    if (file->fd == -1 && !createTempFile(file))
     {
-        handleMemoryError();
+        return FALSE; /* indicate an error (already printed) */
     }
 
-    /* copy the file name and concatenate the extension */
-    strcpy(finalFilename, filename);
-    strcat(finalFilename, EXTERNAL_FILE_EXTENSTION);
+    while (written < size)
+    {
+        ssize_t result = write(file->fd, data + written, size - written);
 
-    /* open the file */
-    externFile = fopen(finalFilename, WRITE);
-    if (externFile == NULL)
+        if (result < 0)
+        {
+            return FALSE; /* indicate an error */
+        }
+        written += (int)result;
+    }
+
+    return TRUE;
+}
+
+/* creates the temporary file of an output file with a given size and maps it to memory, to be written in place
+   (returns NULL on an error) */
+char *mapOutputFile(OutputFile *file, int size)
+{
+    char *data;
+
+    if (!createTempFile(file) || ftruncate(file->fd, size) == -1)
     {
-        printError("Couldn't open file: %s\n", finalFilename);
-        free(finalFilename);
         return NULL; /* indicate an error */
     }
 
-    free(finalFilename);
+    data = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, file->fd, 0);
 
-    return externFile; /* return the file pointer */
+    return data == MAP_FAILED ? NULL : data;
 }
 
-/* function that creates / opens the entry file */
-FILE *openEntryFile(char *filename)
+/* unmaps an output file (the written content stays in the file) */
+void unmapOutputFile(char *data, int size)
 {
-    FILE *entryFile;
+    munmap(data, size);
+}
 
-    /* allocate memory for the new filename with the extension (+ 1 for null-terminator) */
-    char *finalFilename = malloc(strlen(filename) + strlen(ENTRY_FILE_EXTENSTION) + 1);
-    if (!finalFilename)
+/* closes an output file - the temporary file replaces the existing file, unless an error was found
+   (then its removed). an output file that nothing was written to is left as it is. returns FALSE on an error */
+int closeOutputFile(OutputFile *file, int isError)
+{
+    struct stat fileStatus;
+
+    if (file->fd != -1)
     {
-        handleMemoryError();
-    }
+        /* the replaced file keeps its permissions (a new one gets the permissions fopen would give it) */
+        if (!isError && file->existing != NULL && stat(file->path, &fileStatus) == 0 && fchmod(file->fd, fileStatus.st_mode & 07777) != 0)
+        {
+            isError = TRUE;
+        }
 
-    /* copy the file name and concatenate the extension */
-    strcpy(finalFilename, filename);
-    strcat(finalFilename, ENTRY_FILE_EXTENSTION);
+        if (close(file->fd) != 0)
+        {
+            isError = TRUE;
+        }
 
-    /* open the file */
-    entryFile = fopen(finalFilename, WRITE);
-    if (entryFile == NULL)
+        if (isError)
+        {
+            remove(file->tempPath);
+        }
+        else if (rename(file->tempPath, file->path) != 0)
+        {
+            printError("Couldn't replace file: %s\n", file->path);
+            remove(file->tempPath);
+            isError = TRUE;
+        }
+    }
+
+    if (file->existing != NULL)
     {
-        printError("Couldn't open file: %s\n", finalFilename);
-        free(finalFilename);
-        return NULL; /* indicate an error */
+        unmapSourceFile(file->existing);
     }
 
-    free(finalFilename);
+    free(file->tempPath);
+    free(file->path);
+
+    return !isError;
+}
 
-    return entryFile; /* return the file pointer */
+/* prepares the object file */
+void openObjectFile(char *filename, OutputFile *file)
+{
+    openOutputFile(file, filename, OBJECT_FILE_EXTENSION);
+}
+
+/* prepares the binary object file */
+void openBinaryObjectFile(char *filename, OutputFile *file)
+{
+    openOutputFile(file, filename, BINARY_OBJECT_FILE_EXTENSION);
+}
+
+/* prepares the relocation file */
+void openRelocationFile(char *filename, OutputFile *file)
+{
+    openOutputFile(file, filename, RELOCATION_FILE_EXTENSION);
+}
+
+/* prepares the external file */
+void openExternFile(char *filename, OutputFile *file)
+{
+    openOutputFile(file, filename, EXTERNAL_FILE_EXTENSTION);
+}
+
+/* function that prepares the entry file */
+void openEntryFile(char *filename, OutputFile *file)
+{
+    openOutputFile(file, filename, ENTRY_FILE_EXTENSTION);
 }
@@ -6,8 +6,16 @@
 #define OBJECT_FILE_EXTENSION ".ob"
 #define EXTERNAL_FILE_EXTENSTION ".ext"
 #define ENTRY_FILE_EXTENSTION ".ent"
+#define BINARY_OBJECT_FILE_EXTENSION ".obj"
+#define RELOCATION_FILE_EXTENSION ".rel"
 
 /* define the file modes */
 #define READ "r"
 #define WRITE "w"
-#define WRITE_AND_READ "w+"
+
+/* define the permissions of a created output file (before the umask, as fopen creates it) */
+#define OUTPUT_FILE_MODE 0666
+
+/* define the extension of the temporary file an output file is written to, and the most names to try for it */
+#define TEMP_FILE_EXTENSION ".tmp"
+#define MAX_TEMP_FILE_ATTEMPTS 100
@@ -5,14 +5,28 @@
 #define NO_DATA_ARGS_ERROR "No argument found after directive .data. Ensure to add at least 1 argument"
 #define CHAR_OUT_QUOTES "Found character outside of quotation marks in .string directive. Ensure all the characters after the .string directive are wrapped between \"s"
 #define MISSING_ENDING_QUOTE "Expected the ending quotation mark in a .string directive. Ensure to add it"
+#define TOO_MANY_DATA_VALUES_ERROR "Found too many values in a data directive; a directive can have at most %d values"
 #define NUMBER_TOO_BIG "The inserted number is to big. Use number that uses 24 bits or less"
-#define MISSING_WHITE_SPACE_AFTER_COLON "Found a missing whitespace after colon. Ensure to seperate the label name and its definition with a whitespace"
+#define FILL_ARGUMENTS_ERROR "Found a wrong amount of arguments. Use .fill count, value or .zero count"
+#define FILL_COUNT_ERROR "Found an invalid count. Ensure the count is a positive number"
+#define INCBIN_PATH_ERROR "Found an invalid path in a .incbin directive. Ensure the path is wrapped between \"s"
+#define INCBIN_OPEN_ERROR "Couldn't open the file '%s' of a .incbin directive"
+#define INCBIN_TOO_BIG_ERROR "The file '%s' of a .incbin directive is too big. Ensure its words fit in the memory"
 
 /* define a macro that checks if its too large (24 bits signed) */
 #define IS_LARGER_THAN_24_BITS(num) ((num) > 8388607 || (num) < -8388608)
 
+/* define the size of the largest file a .incbin directive can add (its words fill the whole memory) */
+#define MAX_INCBIN_SIZE ((long)(MAX_MEMORY_SIZE) * BYTES_IN_WORD)
+
+/* define the max amount of values in a data directive (a value and a comma take at least 2 characters of a line) */
+#define MAX_DATA_VALUES ((MAX_LINE_LENGTH + 1) / 2)
+
 /* define a function that parses a number in data directive */
 int parseNumberInData(char **, int *);
 
-/* define a function that handles the result of adding to the memory table */
-int handleAddToMemoryTable(MemoryQueue *, int, int);
+/* define a function that adds the words of a data directive to the data image at once */
+int addDataWords(AssemblerContext *, int *, int);
+
+/* define a function that adds a region to the data image (takes the amount of words, the repeated word and the mapped file) */
+int addDataRegion(AssemblerContext *, int, int, SourceFile *);
@@ -1,53 +1,17 @@
 #include "header.h"
 #include "assemble.h"
 #include "firstTransitionHeader.h"
+#include "keywords.h"
 
 /* assisting functions for the first transition: */
 
-/* function that gets the label name (e.g: LABEL: .data 5 gets LABEL) */
-int getLabel(char **line, char *label, int lineNum)
-{
-    int labelLength;
-    char *colon = (char *)strchr(*line, COLON);
-    if (colon == NULL)
-    {
-        return NO_ERROR; /* no label found */
-    }
-
-    labelLength = colon - *line; /* get the label length */
-
-    /* ensure the name of the label is valid */
-    if ((checkLabelName(*line, labelLength, lineNum)) == SYNTAX_ERROR)
-    {
-        /* the error message would be printed in the function */
-        return SYNTAX_ERROR;
-    }
-
-    /* ensure there is a whitespace after the colon */
-    if (!isspace(*(colon + 1)))
-    {
-        printErrorInLine(MISSING_WHITE_SPACE_AFTER_COLON, lineNum);
-        return SYNTAX_ERROR;
-    }
-
-    /* copy the label to the label buffer */
-    strncpy(label, *line, labelLength);
-    label[labelLength] = NULL_TERMINATOR;
-
-    *line = colon + 1; /* move the line pointer to the next character after the colon */
-
-    skipWhiteSpaces(line); /* skip the white spaces after the colon */
-
-    return NO_ERROR; /* found label; no error */
-}
-
 /* function that parses a number in data directive */
 int parseNumberInData(char **line, int *result)
 {
     int number = 0;         /* init the searched number */
     int isNegative = FALSE; /* init the isNegative flag */
 
-    if (**line == NULL_TERMINATOR || isspace(**line))
+    if (IS_WORD_END(**line))
     {
         return MISSING_NUMBER;
     }
@@ -62,9 +26,9 @@ int parseNumberInData(char **line, int *result)
     }
 
     /* ensure the line is only folowed by digits until next whitespace or comma */
-    while (!isspace(**line) && **line != COMMA && **line != NULL_TERMINATOR)
+    while (!IS_OPERAND_END(**line))
     {
-        if (!isdigit(**line))
+        if (!IS_DIGIT(**line))
         {
             /* not a number */
             return INVALID_CHARACTER;
@@ -74,6 +38,11 @@ int parseNumberInData(char **line, int *result)
             /* valid digit */
             int digit = **line - ZERO_CHAR;
             number = number * 10 + digit; /* adjust the number */
+
+            if (number > MAX_NUMBER_MAGNITUDE)
+            {
+                return NUMBER_OUT_OF_RANGE; /* too big for 24 bits, more digits would overflow */
+            }
         }
 
         (*line)++; /* move to the next character */
@@ -90,337 +59,425 @@ int parseNumberInData(char **line, int *result)
     return NO_ERROR; /* indicate no error */
 }
 
-/* function that codes the data after a data directive */
-int codeData(MemoryQueue *queue, char **line, int lineNum)
+/* function that parses the arguments of a data directive (e.g: 5, -3, +7) into a list of values.
+   returns NO_ERROR, or the error that stopped the parsing (the values before it are kept in the list) */
+static int parseDataArguments(char *line, int *values, int *amount)
 {
     /* data should display like this format: n, n, n.... */
 
     int commaFound = TRUE; /* initialize the comma found flag */
-    int addToMemoryResult; /* initialize the add to memory result */
+    int parsedNumberResult;
 
-    /* ensure there are indeed arguments */
-    if (**line == NULL_TERMINATOR)
-    {
-        printErrorInLine(NO_DATA_ARGS_ERROR, lineNum);
-        return SYNTAX_ERROR;
-    }
+    *amount = 0;
 
-    while (**line != NULL_TERMINATOR)
+    while (*line != NULL_TERMINATOR)
     {
-        skipWhiteSpaces(line); /* skip the white spaces */
+        skipWhiteSpaces(&line); /* skip the white spaces */
 
         /* ensure its not the end of the line now */
-        if (**line == NULL_TERMINATOR)
+        if (*line == NULL_TERMINATOR)
         {
             break;
         }
 
-        if (**line != COMMA && commaFound)
+        if (IS_COMMA(*line))
         {
-            /* valid place to look for a number */
-
-            /* extract the number */
-            if (isdigit(**line) || **line == POSITIVE_SIGN || **line == NEGATIVE_SIGN)
+            if (commaFound)
             {
-                int number;
-
-                int parsedNumberResult = parseNumberInData(line, &number);
-
-                /* check for possible errors */
-                if (parsedNumberResult == INVALID_CHARACTER)
-                {
-                    printErrorInLine(FOUND_ILLEGAL_NUMBER, lineNum);
-                    return SYNTAX_ERROR;
-                }
-                else if (parsedNumberResult == MISSING_NUMBER)
-                {
-                    printErrorInLine(FOUND_ILLEGAL_COMMA, lineNum);
-                    return SYNTAX_ERROR;
-                }
-
-                /* ensure the number contains less than 24 bits */
-                if (IS_LARGER_THAN_24_BITS(number))
-                {
-                    printErrorInLine(NUMBER_TOO_BIG, lineNum);
-                    return SYNTAX_ERROR;
-                }
-
-                /* add to memory table */
-                if ((addToMemoryResult = (handleAddToMemoryTable(queue, DC, number))) != NO_ERROR)
-                {
-                    return addToMemoryResult;
-                }
-
-                DC++; /* increment DC */
-
-                commaFound = FALSE;
-            }
-            else
-            {
-                /* the value is not a valid number */
-                printErrorInLine(FOUND_ILLEGAL_NUMBER, lineNum);
-                return SYNTAX_ERROR;
+                return INVALID_COMMA; /* an illegal comma was found */
             }
+
+            commaFound = TRUE; /*  set the coma flag */
+            line++;            /* move past the comma */
+        }
+        else if (!commaFound)
+        {
+            return MISSING_OPERAND_COMMA; /* there is a missing comma */
+        }
+        else if (!IS_NUMBER_START(*line))
+        {
+            return INVALID_CHARACTER; /* the value is not a valid number */
+        }
+        else if (*amount == MAX_DATA_VALUES)
+        {
+            return TOO_MANY_DATA_VALUES; /* there is no room for another value */
         }
         else
         {
-            if (**line == COMMA)
-            {
-                if (commaFound)
-                {
-                    /* an illegal comma was found */
-                    printErrorInLine(FOUND_ILLEGAL_COMMA, lineNum);
-                    return SYNTAX_ERROR;
-                }
-
-                commaFound = TRUE; /*  set the coma flag */
-                (*line)++;         /* move past the comma */
-            }
-            else
+            /* valid place to look for a number, extract it */
+            if ((parsedNumberResult = parseNumberInData(&line, &values[*amount])) != NO_ERROR)
             {
-                /* there is a missing comma */
-                printErrorInLine(MISSING_COMMA_ERROR, lineNum);
-                return SYNTAX_ERROR;
+                return parsedNumberResult;
             }
+
+            (*amount)++;
+            commaFound = FALSE;
         }
     }
 
     /* if there is a comma at the end */
-    if (commaFound)
+    return commaFound ? INVALID_COMMA : NO_ERROR;
+}
+
+/* function that checks if a value of a list doesn't fit in 24 bits (the whole list is checked, without branches) */
+static int hasTooBigValue(int *values, int amount)
+{
+    int tooBig = FALSE;
+    int i;
+
+    for (i = 0; i < amount; i++)
     {
-        printErrorInLine(FOUND_ILLEGAL_COMMA, lineNum);
-        return SYNTAX_ERROR;
+        tooBig |= IS_LARGER_THAN_24_BITS(values[i]);
     }
 
-    return NO_ERROR; /* no error have occured */
+    return tooBig;
 }
 
-/* function that codes the string after a string directive */
-int codeString(MemoryQueue *queue, char **line, int lineNum)
+/* function that parses and checks the values of a data directive (the errors are printed).
+   returns NO_ERROR or SYNTAX_ERROR */
+static int parseDataValues(char *line, int *values, int *amount, int lineNum)
 {
-    int stringLength;
-    int i;
-    int addToMemoryResult;
+    int parseResult = parseDataArguments(line, values, amount);
 
-    if (**line != QUOTE_MARK)
+    /* ensure the numbers contain less than 24 bits (a too big number is reported before a syntax error that follows it) */
+    if (hasTooBigValue(values, *amount))
     {
-        printErrorInLine(CHAR_OUT_QUOTES, lineNum);
+        printErrorInLine(NUMBER_TOO_BIG, lineNum);
         return SYNTAX_ERROR;
     }
 
-    (*line)++; /* move past the first quote mark */
+    /* check for possible errors */
+    switch (parseResult)
+    {
+    case INVALID_CHARACTER:
+        printErrorInLine(FOUND_ILLEGAL_NUMBER, lineNum);
+        return SYNTAX_ERROR;
+    case MISSING_NUMBER:
+    case INVALID_COMMA:
+        printErrorInLine(FOUND_ILLEGAL_COMMA, lineNum);
+        return SYNTAX_ERROR;
+    case MISSING_OPERAND_COMMA:
+        printErrorInLine(MISSING_COMMA_ERROR, lineNum);
+        return SYNTAX_ERROR;
+    case NUMBER_OUT_OF_RANGE:
+        printErrorInLine(NUMBER_TOO_BIG, lineNum);
+        return SYNTAX_ERROR;
+    case TOO_MANY_DATA_VALUES:
+        printErrorInLine(TOO_MANY_DATA_VALUES_ERROR, lineNum, MAX_DATA_VALUES);
+        return SYNTAX_ERROR;
+    }
 
-    /* ensure the string ends with a quote mark */
+    return NO_ERROR;
+}
 
-    /* ignore trailing whitespaces */
-    stringLength = strlen(*line) - 1;
-    while (stringLength >= 0 && isspace((*line)[stringLength]))
+/* function that codes the data after a data directive.
+   the arguments are parsed and checked first, then all the values are added to the data image at once */
+int codeData(AssemblerContext *context, char **line, int lineNum)
+{
+    int values[MAX_DATA_VALUES]; /* initialize the parsed values */
+    int valuesAmount;            /* initialize the amount of parsed values */
+
+    /* ensure there are indeed arguments */
+    if (**line == NULL_TERMINATOR)
     {
-        stringLength--;
+        printErrorInLine(NO_DATA_ARGS_ERROR, lineNum);
+        return SYNTAX_ERROR;
     }
 
-    /* check if the last non-whitespace character is a quote */
-    if (stringLength < 0 || (*line)[stringLength] != QUOTE_MARK)
+    if (parseDataValues(*line, values, &valuesAmount, lineNum) == SYNTAX_ERROR)
     {
-        printErrorInLine(CHAR_OUT_QUOTES, lineNum);
         return SYNTAX_ERROR;
     }
 
-    for (i = 0; i < stringLength; i++, (*line)++)
+    return addDataWords(context, values, valuesAmount);
+}
+
+/* function that codes a run after a fill directive (.fill count, value) or a zero directive (.zero count).
+   the run is kept as a single region of the data image, so its size doesn't matter until the object file is written */
+int codeFill(AssemblerContext *context, char **line, int hasValue, int lineNum)
+{
+    int values[MAX_DATA_VALUES]; /* initialize the parsed values (the count and the value) */
+    int valuesAmount;            /* initialize the amount of parsed values */
+
+    /* ensure there are indeed arguments */
+    if (**line == NULL_TERMINATOR)
     {
-        if ((addToMemoryResult = (handleAddToMemoryTable(queue, DC, **line))) != NO_ERROR)
-        {
-            return addToMemoryResult;
-        }
-        DC++; /* increment DC */
+        printErrorInLine(FILL_ARGUMENTS_ERROR, lineNum);
+        return SYNTAX_ERROR;
     }
 
-    skipWhiteSpaces(line);
+    if (parseDataValues(*line, values, &valuesAmount, lineNum) == SYNTAX_ERROR)
+    {
+        return SYNTAX_ERROR;
+    }
 
-    /* ensure there are no more characters */
-    if (**line != QUOTE_MARK)
+    /* ensure there is a count, and a value only after .fill */
+    if (valuesAmount != (hasValue ? 2 : 1))
     {
-        /* reached the end of the line without the ending quote mark */
-        printErrorInLine(CHAR_OUT_QUOTES, lineNum);
+        printErrorInLine(FILL_ARGUMENTS_ERROR, lineNum);
         return SYNTAX_ERROR;
     }
 
-    /* code the null terminator */
-    if ((addToMemoryResult = (handleAddToMemoryTable(queue, DC, NULL_TERMINATOR))) != NO_ERROR)
+    if (values[0] <= 0)
     {
-        return addToMemoryResult;
+        printErrorInLine(FILL_COUNT_ERROR, lineNum);
+        return SYNTAX_ERROR;
     }
-    DC++; /* increment DC */
 
-    return NO_ERROR; /* no error have occured */
+    return addDataRegion(context, values[0], hasValue ? values[1] : 0, NULL);
 }
 
-/* function that checks if a symbol was already defined */
-int isSymbolDefined(SymbolNode *head, char *symbol)
+/* function that codes the file after an incbin directive (.incbin "file").
+   the file is mapped and kept as a region of the data image (3 bytes in a word), so it's read only when the
+   object file is written */
+int codeIncbin(AssemblerContext *context, char **line, int lineNum)
 {
-    SymbolNode *current = head;
-    while (current)
+    char path[MAX_LINE_LENGTH + 1]; /* initialize the path of the file (+1 for \0) */
+    char *pathEnd;
+    SourceFile *file;
+    long fileSize;
+    int addRegionResult;
+
+    /* the path is wrapped between quote marks */
+    if (!IS_QUOTE(**line) || (pathEnd = strchr(*line + 1, QUOTE_MARK)) == NULL || pathEnd == *line + 1)
     {
+        printErrorInLine(INCBIN_PATH_ERROR, lineNum);
+        return SYNTAX_ERROR;
+    }
 
-        if (strcmp(current->symbol, symbol) == 0)
-        {
-            return TRUE;
-        }
-        current = current->next;
+    strncpy(path, *line + 1, pathEnd - *line - 1);
+    path[pathEnd - *line - 1] = NULL_TERMINATOR;
+
+    /* ensure no extranous characters after the path */
+    *line = pathEnd + 1;
+    skipWhiteSpaces(line);
+    if (**line != NULL_TERMINATOR)
+    {
+        printErrorInLine(INCBIN_PATH_ERROR, lineNum);
+        return SYNTAX_ERROR;
     }
 
-    return FALSE;
-}
+    /* ensure the file fits in the memory before it's mapped (its size is kept in an int) */
+    if ((fileSize = getFileSize(path)) > MAX_INCBIN_SIZE)
+    {
+        printErrorInLine(INCBIN_TOO_BIG_ERROR, lineNum, path);
+        return SYNTAX_ERROR;
+    }
 
-/* function that checks if a directive is either data or string */
-int isDataOrString(char **line)
-{
-    char *temp;
-    int dataDirectiveLength = strlen(DATA_DIRECTIVE);
-    int stringDirectiveLength = strlen(STRING_DIRECTIVE);
-    int found = FALSE; /* hold which directive was found (or not) */
+    if (fileSize == -1 || (file = mapFile(path)) == NULL)
+    {
+        printErrorInLine(INCBIN_OPEN_ERROR, lineNum, path);
+        return SYNTAX_ERROR;
+    }
 
-    if (strncmp(*line, DATA_DIRECTIVE, dataDirectiveLength) == 0)
+    /* an empty file adds no words */
+    if (file->size == 0)
     {
-        temp = *line + dataDirectiveLength;
-        found = DATA_FOUND; /* found data */
+        unmapSourceFile(file);
+        return NO_ERROR;
     }
 
-    if (strncmp(*line, STRING_DIRECTIVE, stringDirectiveLength) == 0)
+    /* the region owns the mapping from now on (it's unmapped by releaseDataRegions) */
+    if ((addRegionResult = addDataRegion(context, (file->size + BYTES_IN_WORD - 1) / BYTES_IN_WORD, 0, file)) != NO_ERROR)
     {
-        temp = *line + stringDirectiveLength;
-        found = STRING_FOUND; /* found string */
+        unmapSourceFile(file);
     }
 
-    if (!found)
+    return addRegionResult;
+}
+
+/* function that codes the string after a string directive (its characters and a null-terminator are added at once) */
+int codeString(AssemblerContext *context, char **line, int lineNum)
+{
+    int values[MAX_LINE_LENGTH + 1]; /* initialize the codes of the characters (+1 for the null-terminator) */
+    int stringLength;
+    int i;
+
+    if (!IS_QUOTE(**line))
     {
-        return FALSE; /* not a directive */
+        printErrorInLine(CHAR_OUT_QUOTES, lineNum);
+        return SYNTAX_ERROR;
     }
 
-    /* ensure no extra characters before the next whitespace */
-    if (!isspace(*temp))
+    (*line)++; /* move past the first quote mark */
+
+    /* ensure the string ends with a quote mark */
+
+    /* ignore trailing whitespaces */
+    stringLength = strlen(*line) - 1;
+    while (stringLength >= 0 && IS_SPACE((*line)[stringLength]))
     {
-        return FALSE; /* not a directive (more characters after) */
+        stringLength--;
     }
 
-    *line = temp; /* update the line pointer to after the label */
+    /* check if the last non-whitespace character is a quote */
+    if (stringLength < 0 || !IS_QUOTE((*line)[stringLength]))
+    {
+        printErrorInLine(CHAR_OUT_QUOTES, lineNum);
+        return SYNTAX_ERROR;
+    }
 
-    skipWhiteSpaces(line); /* is a directive; skip the white spaces */
+    for (i = 0; i < stringLength; i++)
+    {
+        values[i] = (*line)[i];
+    }
+    values[stringLength] = NULL_TERMINATOR; /* code the null terminator */
 
-    return found;
+    return addDataWords(context, values, stringLength + 1);
 }
 
-/* function that checks if a directive is extern */
-int isExtern(char **line)
+/* function that reserves room for some words at the end of a memory image (their addresses are the next ones).
+   returns the first reserved word, or NULL if the memory allocation failed */
+int *reserveMemoryImage(Arena *arena, MemoryImage *image, int amount)
 {
-    char *temp;
-    int externDirectiveLength = strlen(EXTERN_DIRECTIVE);
+    int newCapacity = image->wordsCapacity == 0 ? INITIAL_TABLE_CAPACITY : image->wordsCapacity;
+    int *words;
 
-    if (strncmp(*line, EXTERN_DIRECTIVE, externDirectiveLength) == 0)
+    /* double the capacity until all the words fit */
+    while (newCapacity < image->wordsAmount + amount)
     {
-        temp = *line + externDirectiveLength;
+        newCapacity *= 2;
+    }
 
-        /* ensure no extra characters before the next whitespace */
-        if (isspace(*temp))
+    if (newCapacity != image->wordsCapacity)
+    {
+        if ((words = arenaGrow(arena, image->words, image->wordsCapacity * sizeof(int), newCapacity * sizeof(int))) == NULL)
         {
-            *line = temp;
-            skipWhiteSpaces(line);
-            return TRUE;
+            return NULL; /* memory allocation failed */
         }
+
+        image->words = words;
+        image->wordsCapacity = newCapacity;
     }
-    return FALSE;
+
+    words = image->words + image->wordsAmount;
+    image->wordsAmount += amount;
+
+    return words;
 }
 
-/* function that adds a symbol to the symbol table */
-int addToSymbolTable(SymbolNode **head, char *symbol, int value, char *type)
+/* function that adds a word to the end of a memory image (its address is the next one) */
+int addToMemoryImage(Arena *arena, MemoryImage *image, int code)
 {
-    /* allocate memory for the symbol */
-    SymbolNode *newNode = (SymbolNode *)malloc(sizeof(SymbolNode));
-
-    if (!newNode)
+    int *word = reserveMemoryImage(arena, image, 1);
+    if (word == NULL)
     {
-        return MEMORY_ERROR; /* memory allocation failed */
+        return MEMORY_ERROR; /* indicate a memory allocation error */
     }
 
-    newNode->value = value;
+    *word = code;
 
-    strncpy(newNode->symbol, symbol, MAX_SYMBOL_LENGTH);
-    newNode->symbol[MAX_SYMBOL_LENGTH] = NULL_TERMINATOR;
+    return NO_ERROR; /* added successfully */
+}
 
-    strncpy(newNode->type, type, MAX_TYPE_LENGTH);
-    newNode->type[MAX_TYPE_LENGTH] = NULL_TERMINATOR;
+/* function that adds the words of a data directive to the end of the data image in one reservation.
+   the max memory size is checked once for all of them. returns NO_ERROR, MEMORY_ERROR or MEMORY_OVERFLOW */
+int addDataWords(AssemblerContext *context, int *values, int amount)
+{
+    int *words;
 
-    newNode->isEntry = FALSE; /* will be updated in the second transition if neccessary */
+    /* check if the max memory sized would be reached by the last word */
+    if (context->IC + context->DC + amount > MAX_MEMORY_SIZE)
+    {
+        return MEMORY_OVERFLOW;
+    }
 
-    newNode->next = *head;
+    if ((words = reserveMemoryImage(context->arena, &context->dataImage, amount)) == NULL)
+    {
+        return MEMORY_ERROR; /* indicate a memory error */
+    }
 
-    *head = newNode; /* assign the new node as the head */
+    memcpy(words, values, amount * sizeof(int));
+    context->DC += amount;
 
     return NO_ERROR;
 }
 
-/* function that adds a node to the memory table (queue). the nodes contains given value and code */
-MemoryNode *addToMemoryTable(MemoryQueue *queue, int value, int code)
+/* function that adds a region (a run of a word, or the bytes of a mapped file) to the end of the data image.
+   the region takes no memory until the object file is written. returns NO_ERROR, MEMORY_ERROR or MEMORY_OVERFLOW */
+int addDataRegion(AssemblerContext *context, int wordsAmount, int value, SourceFile *file)
 {
-    MemoryNode *newNode = malloc(sizeof(MemoryNode));
-    if (newNode == NULL)
-    {
-        return NULL; /* indicate a memory allocation error */
-    }
+    MemoryImage *image = &context->dataImage;
+    DataRegion *region;
+    DataRegion *regions;
 
-    /* define the new node's properties */
-    newNode->code = code;
-    newNode->value = value;
-    newNode->wordsAmount = 0; /* initialize as 0 */
-    newNode->next = NULL;
-
-    /* if the queue is empty, set both head and tail */
-    if (queue->tail == NULL)
+    /* check if the max memory sized would be reached by the last word */
+    if (context->IC + context->DC + wordsAmount > MAX_MEMORY_SIZE)
     {
-        queue->head = queue->tail = newNode;
+        return MEMORY_OVERFLOW;
     }
-    else
+
+    if ((regions = growArray(context->arena, image->regions, image->regionsAmount, &image->regionsCapacity, sizeof(DataRegion))) == NULL)
     {
-        /* simply add to the tail */
-        queue->tail->next = newNode;
-        queue->tail = newNode;
+        return MEMORY_ERROR; /* indicate a memory error */
     }
+    image->regions = regions;
+
+    region = &image->regions[image->regionsAmount++];
+    region->position = image->wordsAmount; /* the region comes after the words that were already added */
+    region->wordsAmount = wordsAmount;
+    region->value = value;
+    region->file = file;
 
-    return newNode; /* added successfully, return the new node */
+    context->DC += wordsAmount;
+
+    return NO_ERROR;
 }
 
-/* function that adds the ICF to the value of each symbol that contains data, to correcten their address */
-void updateDataSymbols(SymbolNode **head, int ICF)
+/* function that unmaps the files of the regions of a memory image */
+void releaseDataRegions(MemoryImage *image)
 {
-    SymbolNode *current = *head;
+    int i;
 
-    while (current != NULL)
+    for (i = 0; i < image->regionsAmount; i++)
     {
-        /* check if the symbol is type data */
-        if (strcmp(current->type, TYPE_DATA) == 0)
+        if (image->regions[i].file != NULL)
         {
-            current->value += ICF; /* add ICF to the value */
+            unmapSourceFile(image->regions[i].file);
+            image->regions[i].file = NULL;
         }
-
-        current = current->next;
     }
 }
 
-/* function that handles the result of adding to the memory table */
-int handleAddToMemoryTable(MemoryQueue *queue, int value, int code)
+/* function that adds a filler word to the fixup table (coded once all the symbols are known) */
+int addToFixupTable(AssemblerContext *context, int address, char *symbol, int symbolLength, int isRelative, int baseAddress, int lineNum)
 {
-    MemoryNode *newNode;
+    Fixup *fixup;
+    Fixup *fixups = growArray(context->arena, context->fixups, context->fixupsAmount, &context->fixupsCapacity, sizeof(Fixup));
 
-    if ((newNode = addToMemoryTable(queue, value, code)) == NULL)
+    if (fixups == NULL)
     {
-        return MEMORY_ERROR; /* indicate a memory error */
+        return MEMORY_ERROR; /* memory allocation failed */
     }
+    context->fixups = fixups;
+
+    fixup = &context->fixups[context->fixupsAmount++];
+    fixup->address = address;
+    fixup->symbol = symbol;
+    fixup->symbolLength = symbolLength;
+    fixup->isRelative = isRelative;
+    fixup->baseAddress = baseAddress;
+    fixup->lineNum = lineNum;
+
+    return NO_ERROR;
+}
 
-    /* check if the max memory sized has been reached (+1 for the new node) */
-    if (IC + DC + 1 > MAX_MEMORY_SIZE)
+/* function that adds an entry request (the entry flag is set once all the symbols are known) */
+int addEntryRequest(AssemblerContext *context, char *symbol, int symbolLength, int lineNum)
+{
+    EntryRequest *entry;
+    EntryRequest *entries = growArray(context->arena, context->entries, context->entriesAmount, &context->entriesCapacity, sizeof(EntryRequest));
+
+    if (entries == NULL)
     {
-        return MEMORY_OVERFLOW;
+        return MEMORY_ERROR; /* memory allocation failed */
     }
+    context->entries = entries;
+
+    entry = &context->entries[context->entriesAmount++];
+    memcpy(entry->symbol, symbol, symbolLength);
+    entry->symbol[symbolLength] = NULL_TERMINATOR;
+    entry->lineNum = lineNum;
 
     return NO_ERROR;
 }
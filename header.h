@@ -1,8 +1,16 @@
+/* expose the POSIX functions (threads, memory streams) while compiling with -ansi */
+#define _POSIX_C_SOURCE 200809L
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdarg.h>
 #include <string.h>
-#include <ctype.h>
+
+#include "arena.h"
+#include "lineBuffer.h"
+#include "scanner.h"
+#include "characterClasses.h"
+#include "outputWriter.h"
 
 /* define true and false */
 #define TRUE 1
@@ -28,26 +36,77 @@
 /* define the colon */
 #define COLON ':'
 
+/* define the quote mark (a string, or the path of a file, is wrapped between 2) */
+#define QUOTE_MARK '"'
+
 /* define the amount of registers */
 #define REGISTERS_AMOUNT 8
 
 /* declare a function that returns the final filename */
 char *getFileName(char *);
 
-/* declare a function that opens a file and returns its fp */
-FILE *openAssemblyFile(char *);
+/* define an assembly file that is mapped to memory (read only) */
+typedef struct SourceFile
+{
+   char *data;
+   int size;
+} SourceFile;
+
+/* declare a function that maps an assembly file to memory */
+SourceFile *mapAssemblyFile(char *);
+
+/* declare a function that maps a file to memory, by its path */
+SourceFile *mapFile(char *);
+
+/* declare a function that returns the size of a file, by its path (-1 if it couldn't be found) */
+long getFileSize(char *);
+
+/* declare a function that unmaps a source file */
+void unmapSourceFile(SourceFile *);
+
+/* declare a function that reads the next line of a source file (takes the offset of the line and returns a view of it) */
+int readSourceLine(SourceFile *, int *, LineView *);
 
 /* declare a function that opens / creates the preAssembler file */
 FILE *openPreAssemblerFile(char *);
 
-/* decalre a function that opens / creates the object file */
-FILE *openObjectFile(char *);
+/* declare a function that writes the pre-assembled lines to the preAssembler file */
+void writePreAssemblerFile(char *, LineBuffer *);
+
+/* declare a function that prepares an output file by its name and extension */
+void openOutputFile(OutputFile *, char *, char *);
+
+/* declare a function that checks if the content of an output file is the same as the existing file */
+int isOutputUnchanged(OutputFile *, char *, int);
+
+/* declare a function that writes to the temporary file of an output file (returns FALSE on an error) */
+int writeOutputFile(OutputFile *, char *, int);
+
+/* declare a function that creates the temporary file of an output file with a given size and maps it to memory
+   (returns NULL on an error) */
+char *mapOutputFile(OutputFile *, int);
+
+/* declare a function that unmaps an output file */
+void unmapOutputFile(char *, int);
+
+/* declare a function that closes an output file, replacing the existing file if it was written (takes the error flag,
+   returns FALSE on an error) */
+int closeOutputFile(OutputFile *, int);
+
+/* decalre a function that prepares the object file */
+void openObjectFile(char *, OutputFile *);
 
-/* decalre a function that opens / creates the extern file */
-FILE *openExternFile(char *);
+/* decalre a function that prepares the binary object file */
+void openBinaryObjectFile(char *, OutputFile *);
 
-/* decalre a function that opens / creates the entry file */
-FILE *openEntryFile(char *);
+/* decalre a function that prepares the relocation file */
+void openRelocationFile(char *, OutputFile *);
+
+/* decalre a function that prepares the extern file */
+void openExternFile(char *, OutputFile *);
+
+/* decalre a function that prepares the entry file */
+void openEntryFile(char *, OutputFile *);
 
 /* decalare a function that prints an error */
 void printError(char *, ...);
@@ -55,19 +114,61 @@ void printError(char *, ...);
 /* declare a function that prints an error with a specified line number */
 void printErrorInLine(char *, int, ...);
 
+/* declare a function that sets the stream the current thread prints its messages to */
+void setMessageStream(FILE *);
+
+/* declare a function that returns the stream the current thread prints its messages to */
+FILE *getMessageStream();
+
 /* daclare a function that handles a memory allocation error */
 void handleMemoryError();
 
-/* declare the pre-assembler function (takes a file pointer and a filename, returns TRUE if no
-   error, FALSE otherwize) */
-int preAssembler(FILE *, FILE *);
+/* declare the pre-assembler function (takes the source file, the file name and the buffer of the spread out lines,
+   returns TRUE if an error was found, FALSE otherwize) */
+int preAssembler(SourceFile *, char *, LineBuffer *);
+
+/* declare a function that prepares the cache of the included files (called once, before any file is assembled) */
+void initializeIncludeCache();
+
+/* declare a function that releases the cache of the included files (called once, after every file was assembled) */
+void releaseIncludeCache();
+
+/* define the options of the command line that affect every file */
+typedef struct AssemblerOptions
+{
+   int keepPreAssemblerFile; /* flag if the pre-assembler (.am) file should be written */
+   int binaryObjectFile;     /* flag if the object file is also written in the binary format (.obj) */
+} AssemblerOptions;
+
+/* declare the assembler function (takes the spread out lines, the filename and the options) */
+int assemble(LineBuffer *, char *, AssemblerOptions *);
 
-/* declare the assembler function (takes the spread out assembly file and the filename) */
-int assemble(FILE *, char *);
+/* declare a function that pre-assembles, assembles and writes the output of a single file in a given arena
+   (returns TRUE if an error was found, FALSE otherwise) */
+int assembleFile(char *, AssemblerOptions *, Arena *);
 
 /* declare a function that changes a pointer to point to the first non-white-space character */
 void skipWhiteSpaces(char **);
 
+/* declare a function that makes room for one more element in an array (returns the array, NULL on a memory error) */
+void *growArray(Arena *, void *, int, int *, int);
+
+/* declare a function that returns the hash of a name with a given length */
+unsigned long hashName(char *, int);
+
+/* declare a function that allocates the empty slots of a hash table (returns NULL on a memory error) */
+int *allocateSlots(Arena *, int);
+
+/* define the initial capacity of the growable tables (fixups, entries, symbols, macros and the memory images) */
+#define INITIAL_TABLE_CAPACITY 64
+
+/* define the hashing of the symbol and macro tables (FNV-1a, 32 bits) */
+#define INITIAL_SLOTS_CAPACITY 128 /* must be a power of 2 */
+#define EMPTY_SLOT 0
+#define FNV_OFFSET_BASIS 2166136261UL
+#define FNV_PRIME 16777619UL
+#define HASH_MASK 0xFFFFFFFFUL
+
 /* define error code */
 #define SYNTAX_ERROR -1
 
@@ -77,6 +178,12 @@ void skipWhiteSpaces(char **);
 /* define the preAssember file name */
 #define PRE_ASSEMBLER_FILE_EXTENTION ".am"
 
+/* define the option that writes the pre-assembler file */
+#define KEEP_PRE_ASSEMBLER_FILE_OPTION "--keep-am"
+
+/* define the option that writes the binary object file instead of the text one */
+#define BINARY_OBJECT_FILE_OPTION "--binary-object"
+
 /* define the error message after an error was found while assembling */
 #define ERROR_WHILE_ASSEMBLING "Problem removing the pre-assembler file after an error was found while assembling"
 
@@ -0,0 +1,272 @@
+#include "header.h"
+#include "preAssembler.h"
+#include <pthread.h>
+
+/* the include directive and the cache of the included files: an included file is parsed once per run into its
+   lines and its macros, and every file that includes it (in any worker) adds them without parsing it again.
+   the cache is locked while a file is parsed, the parsed files are read only */
+
+/* the lock of the cache (recursive, since parsing a file parses the files it includes) */
+static pthread_mutex_t cacheLock;
+
+/* the included files, and the arena they are allocated in (released at the end of the run) */
+static IncludedFile *cacheHead = NULL;
+static Arena *cacheArena = NULL;
+
+/* function that prepares the cache of the included files (called once, before any file is assembled) */
+void initializeIncludeCache()
+{
+    pthread_mutexattr_t lockAttributes;
+
+    pthread_mutexattr_init(&lockAttributes);
+    pthread_mutexattr_settype(&lockAttributes, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&cacheLock, &lockAttributes);
+    pthread_mutexattr_destroy(&lockAttributes);
+
+    if ((cacheArena = initializeArena()) == NULL)
+    {
+        handleMemoryError();
+    }
+}
+
+/* function that releases the cache of the included files (called once, after every file was assembled) */
+void releaseIncludeCache()
+{
+    IncludedFile *file;
+
+    for (file = cacheHead; file != NULL; file = file->next)
+    {
+        unmapSourceFile(file->source);
+        free(file->messages);
+    }
+
+    cacheHead = NULL;
+    freeArena(cacheArena);
+    pthread_mutex_destroy(&cacheLock);
+}
+
+/* function that parses a file that was added to the cache (the cache is locked) */
+static void parseIncludedFile(IncludedFile *file)
+{
+    IncludeGuards guards = {NULL, 0, 0};
+    FILE *previousStream = getMessageStream();
+    FILE *messageStream;
+
+    /* the messages are kept, so every file that includes this one prints them */
+    if ((messageStream = open_memstream(&file->messages, &file->messagesSize)) == NULL)
+    {
+        handleMemoryError();
+    }
+
+    /* the file guards itself, so including it again (from a file it includes) does nothing */
+    addIncludeGuard(cacheArena, &guards, file->path);
+
+    setMessageStream(messageStream);
+    fprintf(messageStream, INCLUDED_FILE_MESSAGE, file->path);
+    file->isError = preAssembleLines(file->source, file->lines, file->macros, &guards, file);
+    setMessageStream(previousStream);
+
+    fclose(messageStream); /* also sets the messages buffer */
+}
+
+/* function that returns an included file by its path, parsing it on the first time (NULL if it couldn't be opened).
+   a file that is still parsed (INCLUDE_PARSING) is one that includes itself */
+IncludedFile *getIncludedFile(char *path)
+{
+    IncludedFile *file;
+    SourceFile *source;
+
+    pthread_mutex_lock(&cacheLock);
+
+    for (file = cacheHead; file != NULL; file = file->next)
+    {
+        if (strcmp(file->path, path) == 0)
+        {
+            pthread_mutex_unlock(&cacheLock);
+            return file; /* parsed already (or by this thread, right now) */
+        }
+    }
+
+    if ((source = mapFile(path)) == NULL)
+    {
+        pthread_mutex_unlock(&cacheLock);
+        return NULL; /* the file couldn't be opened */
+    }
+
+    if ((file = arenaAllocate(cacheArena, sizeof(IncludedFile))) == NULL ||
+        (file->path = arenaCopy(cacheArena, path, strlen(path) + 1)) == NULL || /* with the null-terminator */
+        (file->lines = initializeLineBuffer(cacheArena)) == NULL ||
+        (file->macros = initializeMacroTable(cacheArena)) == NULL)
+    {
+        handleMemoryError();
+    }
+
+    file->source = source;
+    file->references = NULL;
+    file->referencesAmount = 0;
+    file->referencesCapacity = 0;
+    file->state = INCLUDE_PARSING;
+    file->isError = FALSE;
+    file->messages = NULL;
+    file->messagesSize = 0;
+
+    /* add the file before parsing it, so a file that includes it back finds it */
+    file->next = cacheHead;
+    cacheHead = file;
+
+    parseIncludedFile(file);
+    file->state = INCLUDE_READY;
+
+    pthread_mutex_unlock(&cacheLock);
+
+    return file;
+}
+
+/* function that handles an include directive (e.g. .include "prelude.as") - adds the included file to the output,
+   or keeps a reference to it when the file that is parsed is an included file itself (self).
+   returns NO_ERROR or SYNTAX_ERROR (the error is printed) */
+int handleInclude(char *text, LineBuffer *output, MacroTable *macros, IncludeGuards *guards, IncludedFile *self, int lineNum)
+{
+    char path[MAX_LINE_LENGTH + 1]; /* initialize the path of the file (+1 for \0) */
+    char *pathEnd;
+    IncludedFile *file;
+
+    skipWhiteSpaces(&text);
+
+    /* the path is wrapped between quote marks */
+    if (!IS_QUOTE(*text) || (pathEnd = strchr(text + 1, QUOTE_MARK)) == NULL || pathEnd == text + 1)
+    {
+        printErrorInLine(INCLUDE_PATH_ERROR, lineNum);
+        return SYNTAX_ERROR;
+    }
+
+    strncpy(path, text + 1, pathEnd - text - 1);
+    path[pathEnd - text - 1] = NULL_TERMINATOR;
+
+    /* ensure no extranous characters after the path */
+    text = pathEnd + 1;
+    skipWhiteSpaces(&text);
+    if (*text != NULL_TERMINATOR)
+    {
+        printErrorInLine(INCLUDE_PATH_ERROR, lineNum);
+        return SYNTAX_ERROR;
+    }
+
+    /* a file that was already included is skipped */
+    if (isIncluded(guards, path))
+    {
+        return NO_ERROR;
+    }
+
+    if ((file = getIncludedFile(path)) == NULL)
+    {
+        printErrorInLine(INCLUDE_OPEN_ERROR, lineNum, path);
+        return SYNTAX_ERROR;
+    }
+
+    /* a file that is still parsed includes itself (through the files it includes), so its the guard that skips it */
+    if (file->state == INCLUDE_PARSING)
+    {
+        return NO_ERROR;
+    }
+
+    if (file->isError)
+    {
+        fputs(file->messages, getMessageStream());
+        printErrorInLine(INCLUDED_FILE_ERROR, lineNum, path);
+        return SYNTAX_ERROR;
+    }
+
+    if (self == NULL)
+    {
+        addIncludedFile(file, output, macros, guards);
+        return NO_ERROR;
+    }
+
+    /* an included file keeps only its own lines (the lines of the other file are added by the files that include it,
+       once, by their own guards). the macros are needed right away, for the rest of the file */
+    addIncludedFile(file, NULL, macros, guards);
+
+    if ((self->references = growArray(output->arena, self->references, self->referencesAmount, &self->referencesCapacity, sizeof(IncludeReference))) == NULL)
+    {
+        handleMemoryError();
+    }
+
+    self->references[self->referencesAmount].position = output->linesAmount;
+    self->references[self->referencesAmount].file = file;
+    self->referencesAmount++;
+
+    return NO_ERROR;
+}
+
+/* function that adds the lines and the macros of an included file (and of the files it includes) to a file.
+   the lines are views into the cache (no copy). a file that was already included is skipped */
+void addIncludedFile(IncludedFile *file, LineBuffer *output, MacroTable *macros, IncludeGuards *guards)
+{
+    int line = 0;
+    int i;
+
+    if (isIncluded(guards, file->path))
+    {
+        return;
+    }
+
+    addIncludeGuard(macros->arena, guards, file->path);
+
+    for (i = 0; i <= file->referencesAmount; i++)
+    {
+        /* the lines before the reference (or all the rest after the last reference) */
+        int linesEnd = i < file->referencesAmount ? file->references[i].position : file->lines->linesAmount;
+
+        for (; output != NULL && line < linesEnd; line++)
+        {
+            LineView *view = getLine(file->lines, line);
+
+            if (!addLine(output, view->start, view->length))
+            {
+                handleMemoryError();
+            }
+        }
+
+        if (i < file->referencesAmount)
+        {
+            addIncludedFile(file->references[i].file, output, macros, guards);
+        }
+    }
+
+    /* its macros can be called from now on (a macro that was defined already gets the included body) */
+    for (i = 0; i < file->macros->macrosAmount; i++)
+    {
+        if (addMacro(macros, file->macros->macros[i].name, &file->macros->macros[i].template) == FALSE)
+        {
+            handleMemoryError();
+        }
+    }
+}
+
+/* function that checks if a path is in the include guards */
+int isIncluded(IncludeGuards *guards, char *path)
+{
+    int i;
+
+    for (i = 0; i < guards->pathsAmount; i++)
+    {
+        if (strcmp(guards->paths[i], path) == 0)
+        {
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
+/* function that adds a path to the include guards (the path must live as long as the guards) */
+void addIncludeGuard(Arena *arena, IncludeGuards *guards, char *path)
+{
+    if ((guards->paths = growArray(arena, guards->paths, guards->pathsAmount, &guards->pathsCapacity, sizeof(char *))) == NULL)
+    {
+        handleMemoryError();
+    }
+
+    guards->paths[guards->pathsAmount++] = path;
+}
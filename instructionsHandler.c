@@ -1,143 +1,64 @@
 #include "header.h"
 #include "assemble.h"
 #include "instructionsHandler.h"
+#include "keywords.h"
+
+/* the instruction table (in the order of the instruction ids in the keyword table) */
+static const Instruction instructionTable[] = INITIALIZE_INSTRUCTION_TABLE;
 
 /* function that handles an instruction line */
-int handleInstruction(char **line, MemoryQueue *queue, int lineNum)
+int handleInstruction(AssemblerContext *context, LineTokens *tokens, int lineNum)
 {
-    Instruction *instruction; /* initialize the instruction */
-
-    /* initialize the instruction name (+1 for null-terminator)*/
-    char instructionName[MAX_INSTRUCTION_NAME_LENGTH] = {NULL_TERMINATOR};
+    int codeInstructionResult;
 
-    /* get the instruction name */
-    getInstructionName(line, instructionName);
-
-    if ((instruction = getInstruction(instructionName)) == NULL)
+    if (tokens->error == INVALID_INSTRUCTION)
     {
         /* not a valid instruction name */
         printErrorInLine(INVALID_INSTRUCTION_NAME, lineNum);
         return SYNTAX_ERROR; /* indicate an error */
     }
-    else
-    {
-        int codeInstructionResult;
 
-        if ((codeInstructionResult = codeInstructionLine(queue, instruction, line, lineNum)) != NO_ERROR)
-        {
-            return codeInstructionResult; /* return the error code */
-        }
+    if ((codeInstructionResult = codeInstructionLine(context, &instructionTable[tokens->mnemonic], tokens, lineNum)) != NO_ERROR)
+    {
+        return codeInstructionResult; /* return the error code */
     }
 
     return TRUE; /* handled successfully */
 }
 
 /* function that codes an instruction line */
-int codeInstructionLine(MemoryQueue *queue, Instruction *instruction, char **line, int lineNum)
+int codeInstructionLine(AssemblerContext *context, const Instruction *instruction, LineTokens *tokens, int lineNum)
 {
-    /* initialize the 2 operands */
-    char *firstOperand = NULL;
-    char *secondOperand = NULL;
-
     int result;
 
-    if (**line != NULL_TERMINATOR)
+    /* the errors found while reading the operands */
+    switch (tokens->error)
     {
-        int commaFound = FALSE; /* flag for if a comma was found or not */
-
-        firstOperand = *line; /* set first operand pointer */
-        while (!isspace(**line) && **line != NULL_TERMINATOR && **line != COMMA)
-        {
-            (*line)++;
-        }
-
-        if (**line != NULL_TERMINATOR)
-        {
-            if (**line == COMMA)
-            {
-                commaFound = TRUE; /* set the commaFound flag */
-            }
-
-            **line = NULL_TERMINATOR; /* null-terminate first operand */
-            (*line)++;
-            skipWhiteSpaces(line);
-
-            /* check for commas between the operands */
-            while (**line == COMMA)
-            {
-                /* check if there are multiple commas (an error) */
-                if (commaFound == TRUE)
-                {
-                    printErrorInLine(CONSECUTIVE_COMMAS_ERROR, lineNum);
-                    return SYNTAX_ERROR;
-                }
-                else
-                {
-                    commaFound = TRUE; /* set the commaFound flag */
-                    (*line)++;
-                    skipWhiteSpaces(line);
-                }
-            }
-
-            if (commaFound)
-            {
-                if (**line != NULL_TERMINATOR)
-                {
-                    secondOperand = *line; /* set second operand pointer */
-
-                    /* skip after the second operand */
-                    while (!isspace(**line) && **line != NULL_TERMINATOR)
-                    {
-                        (*line)++;
-                    }
-
-                    if (**line != NULL_TERMINATOR)
-                    {
-                        **line = NULL_TERMINATOR; /* null-terminate second operand */
-                        (*line)++;
-                    }
-
-                    skipWhiteSpaces(line);
-
-                    /* check for extra characters */
-                    if (**line != NULL_TERMINATOR)
-                    {
-                        printErrorInLine(EXTRA_CHARACTERS_ERROR, lineNum);
-                        return SYNTAX_ERROR;
-                    }
-                }
-                else
-                {
-                    /* a comma without another operand (an error) */
-                    printErrorInLine(INVALID_COMMA_ERROR, lineNum);
-                    return SYNTAX_ERROR;
-                }
-            }
-            else
-            {
-                skipWhiteSpaces(line);
-
-                /* here, if there is another operand, a comma is missing between the 2 */
-                if (**line != NULL_TERMINATOR)
-                {
-                    printErrorInLine(MISSING_COMMA_ERROR, lineNum);
-                    return SYNTAX_ERROR;
-                }
-            }
-        }
+    case CONSECUTIVE_COMMAS:
+        printErrorInLine(CONSECUTIVE_COMMAS_ERROR, lineNum);
+        return SYNTAX_ERROR;
+    case INVALID_COMMA:
+        printErrorInLine(INVALID_COMMA_ERROR, lineNum);
+        return SYNTAX_ERROR;
+    case EXTRA_CHARACTERS:
+        printErrorInLine(EXTRA_CHARACTERS_ERROR, lineNum);
+        return SYNTAX_ERROR;
+    case MISSING_OPERAND_COMMA:
+        printErrorInLine(MISSING_COMMA_ERROR, lineNum);
+        return SYNTAX_ERROR;
     }
 
-    if (firstOperand != NULL && secondOperand != NULL)
+    if (tokens->operandsAmount == 2)
     {
-        result = handle2operands(queue, instruction, firstOperand, secondOperand);
+        result = handle2operands(context, instruction, &tokens->operands[0], &tokens->operands[1], lineNum);
     }
-    else if (firstOperand != NULL)
+    else if (tokens->operandsAmount == 1)
     {
-        result = handle1operands(queue, instruction, firstOperand);
+        result = handle1operands(context, instruction, &tokens->operands[0], lineNum);
     }
     else
     {
-        result = handle0operands(queue, instruction);
+        result = handle0operands(context, instruction);
     }
 
     if (result != NO_ERROR)
@@ -167,6 +88,9 @@ int codeInstructionLine(MemoryQueue *queue, Instruction *instruction, char **lin
         case INVALID_CHARACTER:
             printErrorInLine(INVALID_CHARACTER_ERROR, lineNum);
             break;
+        case NUMBER_OUT_OF_RANGE:
+            printErrorInLine(NUMBER_OUT_OF_RANGE_ERROR, lineNum);
+            break;
         }
 
         return SYNTAX_ERROR;
@@ -176,143 +100,82 @@ int codeInstructionLine(MemoryQueue *queue, Instruction *instruction, char **lin
 }
 
 /* function that handles an instruction line where 2 operands were found */
-int handle2operands(MemoryQueue *queue, Instruction *instruction, char *sourceOperand, char *destOperand)
+int handle2operands(AssemblerContext *context, const Instruction *instruction, Operand *sourceOperand, Operand *destOperand, int lineNum)
 {
-    int sourceAddressingMethod;
-    int destAddressingMethod;
-
-    int sourceRegisterNumber;
-    int destRegisterNumber;
-
     int code; /* init the code */
 
     int sourceCodeResult;
     int destCodeResult;
 
-    MemoryNode *firstWordNode; /* init the first code node */
+    int instructionAddress = context->IC; /* the address of the first word */
 
-    if (!SHOULD_HAVE_2_OPERANDS(instruction->name))
+    if (instruction->operandsAmount != 2)
     {
         return TOO_MANY_OPERANDS;
     }
 
-    /* get the addresing methods */
-    sourceAddressingMethod = getAddressingMethod(sourceOperand);
-    destAddressingMethod = getAddressingMethod(destOperand);
-
-    /* for source operand */
-
-    /* cannot be addressed with the relative addressing method */
-    if (sourceAddressingMethod == RELATIVE_ADDRESSING)
+    /* ensure the instruction allows the addressing methods */
+    if (!IS_ADDRESSING_ALLOWED(instruction->sourceAddressing, sourceOperand->addressing))
     {
         return INVALID_ADDRESSING_METHOD_FIRST_OP;
     }
 
-    /* lea instruction can only accept the direct addressing method */
-    if (strcmp(instruction->name, "lea") == 0 && sourceAddressingMethod != DIRECT_ADDRESSING)
-    {
-        return INVALID_ADDRESSING_METHOD_FIRST_OP;
-    }
-
-    /* for dest operand */
-
-    /* none can use the relative addressing method */
-    if (destAddressingMethod == RELATIVE_ADDRESSING)
-    {
-        return INVALID_ADDRESSING_METHOD_SECOND_OP;
-    }
-
-    /* only cmp can use the immediate addressing method */
-    if (strcmp(instruction->name, "cmp") != 0 && destAddressingMethod == IMMEDIATE_ADDRESSING)
+    if (!IS_ADDRESSING_ALLOWED(instruction->destAddressing, destOperand->addressing))
     {
         return INVALID_ADDRESSING_METHOD_SECOND_OP;
     }
 
     /* code the instruction */
 
-    code = instruction->opcode << OPCODE_POS;
-
-    code |= sourceAddressingMethod << SOURCE_ADDRESSING_POS;
-
-    if ((sourceRegisterNumber = getRegister(sourceOperand)) > 0)
-    {
-        /* not an error; code the register */
-        code |= sourceRegisterNumber << SOURCE_REGISTER_POS;
-    }
-
-    code |= destAddressingMethod << DEST_ADDRESSING_POS;
-
-    if ((destRegisterNumber = getRegister(destOperand)) > 0)
-    {
-        /* not an error; code the register */
-        code |= destRegisterNumber << DEST_REGISTER_POS;
-    }
+    code = INSTRUCTION_WORD(instruction);
 
-    code |= instruction->funct << FUNCT_POS;
+    code |= sourceOperand->addressing << SOURCE_ADDRESSING_POS;
+    code |= getRegisterField(sourceOperand) << SOURCE_REGISTER_POS;
 
-    code |= 1 << A_POS; /* the A is on for the first word. R and E are off */
+    code |= destOperand->addressing << DEST_ADDRESSING_POS;
+    code |= getRegisterField(destOperand) << DEST_REGISTER_POS;
 
-    if ((firstWordNode = addToMemoryTable(queue, IC, code)) == NULL)
+    if ((addToMemoryImage(context->arena, &context->instructionImage, code)) == MEMORY_ERROR)
     {
         return MEMORY_ERROR;
     }
-    IC++; /* increment IC */
+    context->IC++; /* increment IC */
 
     /* ensure the maximum memory has been surpassed */
-    if (IS_MEMORY_OVERFLOW(IC + DC))
+    if (IS_MEMORY_OVERFLOW(context->IC + context->DC))
     {
         return MEMORY_OVERFLOW;
     }
 
-    firstWordNode->wordsAmount++; /* increment the first word's wordsAmount */
-
     /* code the operands */
 
-    sourceCodeResult = handleCodeOperand(queue, sourceOperand, sourceAddressingMethod);
+    sourceCodeResult = handleCodeOperand(context, sourceOperand, instructionAddress, lineNum);
     if (sourceCodeResult != NO_ERROR)
     {
         return sourceCodeResult; /* return the error code */
     }
 
-    /* check if it used another word */
-    if (sourceAddressingMethod != DIRECT_REGISTER_ADDRESSING)
-    {
-        firstWordNode->wordsAmount++; /* increment the first word's wordsAmount */
-    }
-
-    destCodeResult = handleCodeOperand(queue, destOperand, destAddressingMethod);
+    destCodeResult = handleCodeOperand(context, destOperand, instructionAddress, lineNum);
     if (destCodeResult != NO_ERROR)
     {
         return destCodeResult; /* return the error code */
     }
 
-    /* check if it used another word */
-    if (destAddressingMethod != DIRECT_REGISTER_ADDRESSING)
-    {
-        firstWordNode->wordsAmount++; /* increment the first word's wordsAmount */
-    }
-
     return NO_ERROR;
 }
 
 /* function that handles instruction line where 1 operand was found */
-int handle1operands(MemoryQueue *queue, Instruction *instruction, char *destOperand)
+int handle1operands(AssemblerContext *context, const Instruction *instruction, Operand *destOperand, int lineNum)
 {
-    int destAddressingMethod;
-    int destRegisterNumber;
-
     int code; /* init the code */
 
     int destCodeResult;
 
-    MemoryNode *firstWordNode; /* init the first code node */
+    int instructionAddress = context->IC; /* the address of the first word */
 
-    /* variable to hold if the instruction is one of those */
-    int isBneJsrJmp = strcmp(instruction->name, "jmp") == 0 || strcmp(instruction->name, "bne") == 0 || strcmp(instruction->name, "jsr") == 0;
-
-    if (!SHOULD_HAVE_1_OPERAND(instruction->name))
+    if (instruction->operandsAmount != 1)
     {
-        if (SHOULD_HAVE_0_OPERANDS(instruction->name))
+        if (instruction->operandsAmount == 0)
         {
             return TOO_MANY_OPERANDS;
         }
@@ -322,366 +185,123 @@ int handle1operands(MemoryQueue *queue, Instruction *instruction, char *destOper
         }
     }
 
-    /* get the addresing method */
-    destAddressingMethod = getAddressingMethod(destOperand);
-
-    /* jmp, bne and jsr can only be addressed with direct or relative addressing methods */
-    if (isBneJsrJmp && destAddressingMethod != DIRECT_ADDRESSING && destAddressingMethod != RELATIVE_ADDRESSING)
-    {
-        return INVALID_ADDRESSING_METHOD_FIRST_OP;
-    }
-
-    /* the rest can be addressed only with direct or direct-register addressing methods
-       (or if its prn immediate addressing could be used) */
-    if (!isBneJsrJmp && (destAddressingMethod == RELATIVE_ADDRESSING || (destAddressingMethod == IMMEDIATE_ADDRESSING && strcmp(instruction->name, "prn") != 0)))
+    /* ensure the instruction allows the addressing method */
+    if (!IS_ADDRESSING_ALLOWED(instruction->destAddressing, destOperand->addressing))
     {
         return INVALID_ADDRESSING_METHOD_FIRST_OP;
     }
 
     /* code the instruction (here source addressing method and source register are 0) */
 
-    code = instruction->opcode << OPCODE_POS;
-
-    code |= destAddressingMethod << DEST_ADDRESSING_POS;
-
-    if ((destRegisterNumber = getRegister(destOperand)) > 0)
-    { /* not an error; code the register */
-        code |= destRegisterNumber << DEST_REGISTER_POS;
-    }
-
-    code |= instruction->funct << FUNCT_POS;
+    code = INSTRUCTION_WORD(instruction);
 
-    code |= 1 << A_POS; /* the A is on for the first word. R and E are off */
+    code |= destOperand->addressing << DEST_ADDRESSING_POS;
+    code |= getRegisterField(destOperand) << DEST_REGISTER_POS;
 
-    if ((firstWordNode = addToMemoryTable(queue, IC, code)) == NULL)
+    if ((addToMemoryImage(context->arena, &context->instructionImage, code)) == MEMORY_ERROR)
     {
         return MEMORY_ERROR;
     }
-    IC++; /* increment IC */
+    context->IC++; /* increment IC */
 
     /* ensure the maximum memory has been surpassed */
-    if (IS_MEMORY_OVERFLOW(IC + DC))
+    if (IS_MEMORY_OVERFLOW(context->IC + context->DC))
     {
         return MEMORY_OVERFLOW;
     }
 
-    firstWordNode->wordsAmount++; /* increment the first word's wordsAmount */
-
     /* code the operand */
-    destCodeResult = handleCodeOperand(queue, destOperand, destAddressingMethod);
+    destCodeResult = handleCodeOperand(context, destOperand, instructionAddress, lineNum);
     if (destCodeResult != NO_ERROR)
     {
         return destCodeResult; /* return the error code */
     }
 
-    /* check if it used another word */
-    if (destAddressingMethod != DIRECT_REGISTER_ADDRESSING)
-    {
-        firstWordNode->wordsAmount++; /* increment the first word's wordsAmount */
-    }
-
     return NO_ERROR;
 }
 
 /* function that handles an instruction line where 0 operands were found */
-int handle0operands(MemoryQueue *queue, Instruction *instruction)
+int handle0operands(AssemblerContext *context, const Instruction *instruction)
 {
     int code; /* init the code */
 
-    MemoryNode *firstWordNode; /* init the first code node */
-
-    if (!SHOULD_HAVE_0_OPERANDS(instruction->name))
+    if (instruction->operandsAmount != 0)
     {
         return NOT_ENOUGH_OPERANDS;
     }
 
-    /* code the insruction (here it only has opcode, rest is 0 accept the A) */
-    code = instruction->opcode << OPCODE_POS;
+    /* code the insruction (here it only has opcode and funct, rest is 0 accept the A) */
+    code = INSTRUCTION_WORD(instruction);
 
-    /* funct is 0 */
-
-    code |= 1 << A_POS; /* the A is on for the first word. R and E are off */
-
-    if ((firstWordNode = addToMemoryTable(queue, IC, code)) == NULL)
+    if ((addToMemoryImage(context->arena, &context->instructionImage, code)) == MEMORY_ERROR)
     {
         return MEMORY_ERROR;
     }
-    IC++; /* increment IC */
+    context->IC++; /* increment IC */
 
     /* ensure the maximum memory has been surpassed */
-    if (IS_MEMORY_OVERFLOW(IC + DC))
+    if (IS_MEMORY_OVERFLOW(context->IC + context->DC))
     {
         return MEMORY_OVERFLOW;
     }
 
-    firstWordNode->wordsAmount++; /* increment the first word's wordsAmount */
-
     return NO_ERROR;
 }
 
+/* function that returns the register field of an operand (the register number, or 0 if its not a register) */
+int getRegisterField(Operand *operand)
+{
+    return operand->addressing == DIRECT_REGISTER_ADDRESSING ? operand->value : 0;
+}
+
 /* function that handles coding an operand */
-int handleCodeOperand(MemoryQueue *queue, char *operand, int addressingMethod)
+int handleCodeOperand(AssemblerContext *context, Operand *operand, int instructionAddress, int lineNum)
 {
+    int addressingMethod = operand->addressing;
+
     if (addressingMethod == DIRECT_ADDRESSING || addressingMethod == RELATIVE_ADDRESSING)
     {
-        /* still unable to get the value. insert a filler to the memory table (will be coded on the second transition) */
+        /* still unable to get the value. insert a filler to the memory table and remember to code it
+           once the first transition is done (the symbol might be defined later) */
+        int fillerAddress = context->IC;
+        int isRelativeAddressing = addressingMethod == RELATIVE_ADDRESSING;
 
-        if ((addToMemoryTable(queue, IC, CODE_FILLER)) == NULL)
+        if ((addToMemoryImage(context->arena, &context->instructionImage, CODE_FILLER)) == MEMORY_ERROR)
+        {
+            return MEMORY_ERROR;
+        }
+        context->IC++; /* increment IC */
+
+        /* skip the ampersand of relative addressing */
+        if ((addToFixupTable(context, fillerAddress, operand->start + isRelativeAddressing, operand->length - isRelativeAddressing, isRelativeAddressing, instructionAddress, lineNum)) == MEMORY_ERROR)
         {
             return MEMORY_ERROR;
         }
-        IC++; /* increment IC */
     }
     else if (addressingMethod == IMMEDIATE_ADDRESSING)
     {
-        /* can code it right now */
-        int number;            /* init the number */
-        int parseNumberResult; /* init the result code */
-
-        /* +1 to skip the hashtag */
-        if ((parseNumberResult = parseNumber(operand + 1, &number)) == NO_ERROR)
+        /* can code it right now (the number was already parsed by the lexer) */
+        if (operand->valueResult == NO_ERROR)
         {
             /* code the number (with ARE as A is on, R and E are off) */
-            int code = (number << ARE_LENGTH) | (1 << A_POS);
-            if ((addToMemoryTable(queue, IC, code)) == NULL)
+            int code = (operand->value << ARE_LENGTH) | (1 << A_POS);
+            if ((addToMemoryImage(context->arena, &context->instructionImage, code)) == MEMORY_ERROR)
             {
                 return MEMORY_ERROR;
             }
-            IC++; /* increment IC */
+            context->IC++; /* increment IC */
         }
         else
         {
-            return parseNumberResult; /* return the result error */
+            return operand->valueResult; /* return the result error */
         }
     }
 
     /* ensure the maximum memory has been surpassed */
-    if (IS_MEMORY_OVERFLOW(IC + DC))
+    if (IS_MEMORY_OVERFLOW(context->IC + context->DC))
     {
         return MEMORY_OVERFLOW;
     }
 
     return NO_ERROR;
 }
-
-/* function that returns the instruction found (NULL if not found) */
-Instruction *getInstruction(char *word)
-{
-    static Instruction instructionTable[] = INITIALIZE_INSTRUCTION_TABLE;
-
-    Instruction *found = NULL; /* initialize the returned insrtuction */
-    int i;                     /* initialize iterator */
-
-    for (i = 0; i < INSTRUCTION_TABLE_LENGTH; i++)
-    {
-        if (strcmp(word, instructionTable[i].name) == 0)
-        {
-            found = &instructionTable[i]; /* found a suspect to be an instruction name */
-            break;
-        }
-    }
-
-    return found;
-}
-
-/* function that returns the addressing method of an operand */
-int getAddressingMethod(char *operand)
-{
-    int registerResult;
-
-    if (*operand == HASHTAG)
-    {
-        return IMMEDIATE_ADDRESSING;
-    }
-
-    if (*operand == AMPERSAND)
-    {
-        return RELATIVE_ADDRESSING;
-    }
-
-    /* check about the register */
-    registerResult = getRegister(operand);
-
-    if (registerResult >= FIRST_REGISTER_NUM && registerResult <= LAST_REGISTER_NUM)
-    {
-        return DIRECT_REGISTER_ADDRESSING;
-    }
-
-    /* if its not one of those, its direct addressing */
-    return DIRECT_ADDRESSING;
-}
-
-void getInstructionName(char **line, char *instruction)
-{
-    int i = 0;
-
-    /* copy the word while ignoring any trailing whitespace */
-    while (**line != NULL_TERMINATOR && !isspace(**line) && i < MAX_INSTRUCTION_NAME_LENGTH)
-    {
-        instruction[i++] = **line;
-        (*line)++; /* move to the next character */
-    }
-
-    instruction[i] = NULL_TERMINATOR; /* null-terminate the instruction */
-
-    /* ensure there is no additional characters */
-
-    skipWhiteSpaces(line); /* skip whitespaces */
-}
-
-/* function gets a parsed number from a word */
-int parseNumber(char *word, int *result)
-{
-    int number = 0;         /* init the searched number */
-    int isNegative = FALSE; /* init the isNegative flag */
-
-    if (*word == NULL_TERMINATOR || isspace(*word))
-    {
-        return MISSING_NUMBER;
-    }
-
-    if (*word == NEGATIVE_SIGN || *word == POSITIVE_SIGN)
-    {
-        if (*word == NEGATIVE_SIGN)
-        {
-            isNegative = TRUE; /* a negative number */
-        }
-        word++; /* move to the next character */
-    }
-
-    /* ensure the line is only folowed by digits until next whitespace */
-    while (!isspace(*word) && *word != NULL_TERMINATOR)
-    {
-        if (!isdigit(*word))
-        {
-            /* not a number */
-            return INVALID_CHARACTER;
-        }
-        else
-        {
-            /* valid digit */
-            int digit = *word - ZERO_CHAR;
-            number = number * 10 + digit; /* adjust the number */
-        }
-
-        word++; /* move to the next character */
-    }
-
-    /* get the final number */
-    if (isNegative)
-    {
-        number = -number; /* change to negative */
-    }
-
-    *result = number; /* change the result */
-
-    return NO_ERROR; /* indicate no error */
-}
-
-/* function that gets the register from an operand */
-int getRegister(char *operand)
-{
-    int firstDigit; /* init the first digit after 'r' */
-
-    /* first charater must be 'r' */
-    if (*operand != 'r')
-    {
-        return NOT_A_REGISTER; /* not a register */
-    }
-
-    operand++; /* move to the next character */
-
-    /* have to be a number after that */
-
-    /* check if the next character is a digit */
-    if (!isdigit(*operand))
-    {
-        return NOT_A_REGISTER; /* not a register */
-    }
-
-    firstDigit = *operand;
-
-    operand++; /* move to the next character */
-
-    if (!isspace(*operand) && *operand != NULL_TERMINATOR)
-    {
-        if (isdigit(*operand))
-        {
-            /* move to the next non-digit character */
-            while (!isdigit(*(++operand)))
-                ;
-
-            /* if its a whitespace, invalid register number (can only get 0-7 and this is multiple digits) */
-            if (isspace(*operand) || *operand == NULL_TERMINATOR)
-            {
-                return INVALID_REGISTER_NUM;
-            }
-            else
-            {
-                /* simply not a register */
-                return NOT_A_REGISTER;
-            }
-        }
-        else
-        {
-            return NOT_A_REGISTER; /* not a register */
-        }
-    }
-
-    /* check if the first digit is valid */
-    if (firstDigit > SEVEN_CHAR)
-    {
-        return INVALID_REGISTER_NUM;
-    }
-
-    firstDigit = firstDigit - ZERO_CHAR; /* parse to an actual number */
-
-    return firstDigit; /* valid register */
-}
-
-/* function that checks if a line starts with an instrcution */
-int isStartWithInstruction(char **line)
-{
-    int length = 0;
-    int i;
-    Instruction instructionTable[] = INITIALIZE_INSTRUCTION_TABLE;
-
-    /* get the length of the first word */
-    while (!isspace((*line)[length]))
-    {
-        length++;
-    }
-
-    for (i = 0; i < INSTRUCTION_TABLE_LENGTH; i++)
-    {
-        if (strncmp(instructionTable[i].name, *line, length) == 0)
-        {
-            /* does start with an instruction */
-
-            *line = *line + length; /* skip to after the instruction name */
-            skipWhiteSpaces(line);  /* skip whitespaces */
-
-            return TRUE;
-        }
-    }
-
-    return FALSE; /* not an instruction name */
-}
-
-/* function that checks if a string is an instruction (takes the first char and its length) */
-int isInstruction(char *start, int length)
-{
-    int i;
-    Instruction instructionTable[] = INITIALIZE_INSTRUCTION_TABLE;
-
-    /* check each instruction name */
-    for (i = 0; i < INSTRUCTION_TABLE_LENGTH; i++)
-    {
-        if (strncmp(instructionTable[i].name, start, length) == 0)
-        {
-            return TRUE; /* is an instruction name */
-        }
-    }
-
-    return FALSE; /* didnt find a corresponding instruction name */
-}
\ No newline at end of file
@@ -3,60 +3,69 @@
 typedef struct
 {
     char *name;
-    int funct;  /* in decimal */
-    int opcode; /* in decimal */
+    int funct;            /* in decimal */
+    int opcode;           /* in decimal */
+    int operandsAmount;   /* the amount of operands the instruction takes */
+    int sourceAddressing; /* the addressing methods allowed for the source operand (a mask of ADDRESSING_MASK bits) */
+    int destAddressing;   /* the addressing methods allowed for the destination operand */
 } Instruction;
 
-/* define an instruction table initializer */
-#define INITIALIZE_INSTRUCTION_TABLE \
-    {                                \
-        {"mov", 0, 0},               \
-        {"cmp", 0, 1},               \
-        {"add", 1, 2},               \
-        {"sub", 2, 2},               \
-        {"lea", 0, 4},               \
-        {"clr", 1, 5},               \
-        {"not", 2, 5},               \
-        {"inc", 3, 5},               \
-        {"dec", 4, 5},               \
-        {"jmp", 1, 9},               \
-        {"bne", 2, 9},               \
-        {"jsr", 3, 9},               \
-        {"red", 0, 12},              \
-        {"prn", 0, 13},              \
-        {"rts", 0, 14},              \
-        {"stop", 0, 15},             \
+/* define the masks of the addressing methods */
+#define ADDRESSING_MASK(method) (1 << (method))
+#define IMMEDIATE_MASK ADDRESSING_MASK(IMMEDIATE_ADDRESSING)
+#define DIRECT_MASK ADDRESSING_MASK(DIRECT_ADDRESSING)
+#define RELATIVE_MASK ADDRESSING_MASK(RELATIVE_ADDRESSING)
+#define REGISTER_MASK ADDRESSING_MASK(DIRECT_REGISTER_ADDRESSING)
+
+/* define the groups of addressing methods used by the instructions */
+#define NO_OPERAND_MASK 0
+#define VALUE_MASK (IMMEDIATE_MASK | DIRECT_MASK | REGISTER_MASK) /* any operand that has a value */
+#define TARGET_MASK (DIRECT_MASK | REGISTER_MASK)                 /* an operand that can be written to */
+#define JUMP_MASK (DIRECT_MASK | RELATIVE_MASK)                   /* a jump target */
+
+/* define an instruction table initializer (in the order of the instruction ids in the keyword table).
+   a row holds the name, funct, opcode, amount of operands and the allowed source and destination addressing methods */
+#define INITIALIZE_INSTRUCTION_TABLE                          \
+    {                                                         \
+        {"mov", 0, 0, 2, VALUE_MASK, TARGET_MASK},            \
+        {"cmp", 0, 1, 2, VALUE_MASK, VALUE_MASK},             \
+        {"add", 1, 2, 2, VALUE_MASK, TARGET_MASK},            \
+        {"sub", 2, 2, 2, VALUE_MASK, TARGET_MASK},            \
+        {"lea", 0, 4, 2, DIRECT_MASK, TARGET_MASK},           \
+        {"clr", 1, 5, 1, NO_OPERAND_MASK, TARGET_MASK},       \
+        {"not", 2, 5, 1, NO_OPERAND_MASK, TARGET_MASK},       \
+        {"inc", 3, 5, 1, NO_OPERAND_MASK, TARGET_MASK},       \
+        {"dec", 4, 5, 1, NO_OPERAND_MASK, TARGET_MASK},       \
+        {"jmp", 1, 9, 1, NO_OPERAND_MASK, JUMP_MASK},         \
+        {"bne", 2, 9, 1, NO_OPERAND_MASK, JUMP_MASK},         \
+        {"jsr", 3, 9, 1, NO_OPERAND_MASK, JUMP_MASK},         \
+        {"red", 0, 12, 1, NO_OPERAND_MASK, TARGET_MASK},      \
+        {"prn", 0, 13, 1, NO_OPERAND_MASK, VALUE_MASK},       \
+        {"rts", 0, 14, 0, NO_OPERAND_MASK, NO_OPERAND_MASK},  \
+        {"stop", 0, 15, 0, NO_OPERAND_MASK, NO_OPERAND_MASK}, \
     }
 
 /* define the length */
 #define INSTRUCTION_TABLE_LENGTH 16
 
-/* declare a function that codes the instruction line */
-int codeInstructionLine(MemoryQueue *, Instruction *, char **, int);
+/* declare a function that codes the instruction line (takes the token record of the line) */
+int codeInstructionLine(AssemblerContext *, const Instruction *, LineTokens *, int);
 
 /* declare a function that handles 2-operands instructions */
-int handle2operands(MemoryQueue *, Instruction *, char *, char *);
+int handle2operands(AssemblerContext *, const Instruction *, Operand *, Operand *, int);
 
 /* declare a function that handles 1-operand instructions */
-int handle1operands(MemoryQueue *, Instruction *, char *);
+int handle1operands(AssemblerContext *, const Instruction *, Operand *, int);
 
 /* declare a function that handles 0-operand instructions */
-int handle0operands(MemoryQueue *, Instruction *);
+int handle0operands(AssemblerContext *, const Instruction *);
 
-/* declare a function that codes an operand */
-int handleCodeOperand(MemoryQueue *, char *, int);
+/* declare a function that returns the register field of an operand */
+int getRegisterField(Operand *);
 
-/* declare a function that gets the insruction name */
-void getInstructionName(char **, char *);
-
-/* declare a function that parses a number */
-int parseNumber(char *, int *);
-
-/* declare a function that checks if a word is an instruction and returns it if so */
-Instruction *getInstruction(char *);
-
-/* declare a function that returns the addressing method */
-int getAddressingMethod(char *);
+/* declare a function that codes an operand (takes the address of its instruction and the line number
+   for words that are left to the fixup table) */
+int handleCodeOperand(AssemblerContext *, Operand *, int, int);
 
 /* define addressing methods */
 #define IMMEDIATE_ADDRESSING 0
@@ -64,14 +73,11 @@ int getAddressingMethod(char *);
 #define RELATIVE_ADDRESSING 2
 #define DIRECT_REGISTER_ADDRESSING 3
 
-/* define the first and last register numbers */
-#define FIRST_REGISTER_NUM 0
-#define LAST_REGISTER_NUM 7
-
 /* define some error messages */
 #define MISSING_NUMBER_ERROR "Found '#' without a following number. Ensure to insert the number"
 #define MISSING_COMMA_ERROR "Found a missing comma in instruction line. Ensure to insert a comma between operands"
 #define INVALID_CHARACTER_ERROR "'#' can only be followed by a number. Found a character after '#'s. Ensure to enter a valid number"
+#define NUMBER_OUT_OF_RANGE_ERROR "Found a too big number after '#'. Ensure to use a number that uses 24 bits or less"
 #define TOO_MANY_OPERANDS_ERROR "Found too many operands for instruction '%s'. Ensure to enter the correct amount"
 #define NOT_ENOUGH_OPERANDS_ERROR "Not enough operands were inserted for instruction '%s'. Ensure to enter the correct amount"
 #define INVALID_ADDRESSING_METHOD_FIRST_OP_ERROR "Invalid addressing method for the first operand. Ensure to use a valid one"
@@ -80,30 +86,11 @@ int getAddressingMethod(char *);
 #define INVALID_COMMA_ERROR "Found unexpected comma after first operand. Ensure to remove this comma, or insert a second operand, if wanted"
 #define EXTRA_CHARACTERS_ERROR "found extra characters after the second operand. Try removing those"
 
-/* define a macro that checks if an instruction name should have 2 operands */
-#define SHOULD_HAVE_2_OPERANDS(name) \
-    (strcmp((name), "mov") == 0 ||   \
-     strcmp((name), "add") == 0 ||   \
-     strcmp((name), "sub") == 0 ||   \
-     strcmp((name), "lea") == 0 ||   \
-     strcmp((name), "cmp") == 0)
-
-/* define a macro that checks if an instruction name should have 1 operand */
-#define SHOULD_HAVE_1_OPERAND(name) \
-    (strcmp((name), "clr") == 0 ||  \
-     strcmp((name), "not") == 0 ||  \
-     strcmp((name), "inc") == 0 ||  \
-     strcmp((name), "dec") == 0 ||  \
-     strcmp((name), "jmp") == 0 ||  \
-     strcmp((name), "bne") == 0 ||  \
-     strcmp((name), "jsr") == 0 ||  \
-     strcmp((name), "red") == 0 ||  \
-     strcmp((name), "prn") == 0)
-
-/* define a macro that checks if an instruction name should have 0 operands */
-#define SHOULD_HAVE_0_OPERANDS(name) \
-    (strcmp((name), "rts") == 0 ||   \
-     strcmp((name), "stop") == 0)
+/* define a macro that checks if an addressing method is allowed by a mask */
+#define IS_ADDRESSING_ALLOWED(mask, method) (((mask) & ADDRESSING_MASK(method)) != 0)
+
+/* define a macro that returns the first word of an instruction (its operand fields are still 0. A is on, R and E are off) */
+#define INSTRUCTION_WORD(instruction) (((instruction)->opcode << OPCODE_POS) | ((instruction)->funct << FUNCT_POS) | (1 << A_POS))
 
 /* define a macro that checks if the maximum memory has been surpassed */
 #define IS_MEMORY_OVERFLOW(memory) ((memory) > MAX_MEMORY_SIZE)
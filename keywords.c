@@ -0,0 +1,94 @@
+#include "header.h"
+#include "keywords.h"
+
+/* the keyword table - every keyword sits in the slot of its hash (KEYWORD_HASH), so a token is classified
+   with a single probe. the hash has no collisions between the keywords, so adding a keyword requires
+   choosing a slot that is still empty (or new hash multipliers). a keyword can't be a macro name either */
+static const Keyword keywordTable[KEYWORD_TABLE_SIZE] =
+{
+    {"inc", 3, INSTRUCTION_KEYWORD, 7}, /* 0 */
+    {"extern", 6, DIRECTIVE_KEYWORD, EXTERN_DIRECTIVE_ID}, /* 1 */
+    {NULL, 0, 0, 0}, /* 2 */
+    {"incbin", 6, DIRECTIVE_KEYWORD, INCBIN_DIRECTIVE_ID}, /* 3 */
+    {"clr", 3, INSTRUCTION_KEYWORD, 5}, /* 4 */
+    {"mov", 3, INSTRUCTION_KEYWORD, 0}, /* 5 */
+    {"r6", 2, REGISTER_KEYWORD, 6}, /* 6 */
+    {"zero", 4, DIRECTIVE_KEYWORD, ZERO_DIRECTIVE_ID}, /* 7 */
+    {NULL, 0, 0, 0}, /* 8 */
+    {"data", 4, DIRECTIVE_KEYWORD, DATA_DIRECTIVE_ID}, /* 9 */
+    {NULL, 0, 0, 0}, /* 10 */
+    {"r3", 2, REGISTER_KEYWORD, 3}, /* 11 */
+    {"not", 3, INSTRUCTION_KEYWORD, 6}, /* 12 */
+    {NULL, 0, 0, 0}, /* 13 */
+    {"red", 3, INSTRUCTION_KEYWORD, 12}, /* 14 */
+    {"bne", 3, INSTRUCTION_KEYWORD, 10}, /* 15 */
+    {"r0", 2, REGISTER_KEYWORD, 0}, /* 16 */
+    {NULL, 0, 0, 0}, /* 17 */
+    {NULL, 0, 0, 0}, /* 18 */
+    {NULL, 0, 0, 0}, /* 19 */
+    {"jsr", 3, INSTRUCTION_KEYWORD, 11}, /* 20 */
+    {"prn", 3, INSTRUCTION_KEYWORD, 13}, /* 21 */
+    {NULL, 0, 0, 0}, /* 22 */
+    {NULL, 0, 0, 0}, /* 23 */
+    {NULL, 0, 0, 0}, /* 24 */
+    {NULL, 0, 0, 0}, /* 25 */
+    {NULL, 0, 0, 0}, /* 26 */
+    {NULL, 0, 0, 0}, /* 27 */
+    {NULL, 0, 0, 0}, /* 28 */
+    {"r5", 2, REGISTER_KEYWORD, 5}, /* 29 */
+    {"jmp", 3, INSTRUCTION_KEYWORD, 9}, /* 30 */
+    {"fill", 4, DIRECTIVE_KEYWORD, FILL_DIRECTIVE_ID}, /* 31 */
+    {NULL, 0, 0, 0}, /* 32 */
+    {NULL, 0, 0, 0}, /* 33 */
+    {"r2", 2, REGISTER_KEYWORD, 2}, /* 34 */
+    {NULL, 0, 0, 0}, /* 35 */
+    {"lea", 3, INSTRUCTION_KEYWORD, 4}, /* 36 */
+    {"sub", 3, INSTRUCTION_KEYWORD, 3}, /* 37 */
+    {"entry", 5, DIRECTIVE_KEYWORD, ENTRY_DIRECTIVE_ID}, /* 38 */
+    {NULL, 0, 0, 0}, /* 39 */
+    {NULL, 0, 0, 0}, /* 40 */
+    {NULL, 0, 0, 0}, /* 41 */
+    {NULL, 0, 0, 0}, /* 42 */
+    {NULL, 0, 0, 0}, /* 43 */
+    {"dec", 3, INSTRUCTION_KEYWORD, 8}, /* 44 */
+    {"cmp", 3, INSTRUCTION_KEYWORD, 1}, /* 45 */
+    {"add", 3, INSTRUCTION_KEYWORD, 2}, /* 46 */
+    {"r7", 2, REGISTER_KEYWORD, 7}, /* 47 */
+    {NULL, 0, 0, 0}, /* 48 */
+    {NULL, 0, 0, 0}, /* 49 */
+    {NULL, 0, 0, 0}, /* 50 */
+    {NULL, 0, 0, 0}, /* 51 */
+    {"r4", 2, REGISTER_KEYWORD, 4}, /* 52 */
+    {"rts", 3, INSTRUCTION_KEYWORD, 14}, /* 53 */
+    {NULL, 0, 0, 0}, /* 54 */
+    {NULL, 0, 0, 0}, /* 55 */
+    {NULL, 0, 0, 0}, /* 56 */
+    {"r1", 2, REGISTER_KEYWORD, 1}, /* 57 */
+    {NULL, 0, 0, 0}, /* 58 */
+    {NULL, 0, 0, 0}, /* 59 */
+    {NULL, 0, 0, 0}, /* 60 */
+    {"stop", 4, INSTRUCTION_KEYWORD, 15}, /* 61 */
+    {NULL, 0, 0, 0}, /* 62 */
+    {"string", 6, DIRECTIVE_KEYWORD, STRING_DIRECTIVE_ID}  /* 63 */
+};
+
+/* function that returns the keyword of a token with a given length (NULL if its not a keyword) */
+const Keyword *getKeyword(char *token, int length)
+{
+    const Keyword *keyword;
+
+    /* shorter or longer tokens can't be keywords (also ensures the hash only reads the token) */
+    if (length < MIN_KEYWORD_LENGTH || length > MAX_KEYWORD_LENGTH)
+    {
+        return NULL;
+    }
+
+    keyword = &keywordTable[KEYWORD_HASH(token, length)];
+
+    if (keyword->name == NULL || keyword->length != length || memcmp(keyword->name, token, length) != 0)
+    {
+        return NULL; /* an empty slot or a different keyword */
+    }
+
+    return keyword;
+}
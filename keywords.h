@@ -0,0 +1,35 @@
+/* define a keyword - an instruction name, a register name or a directive name (without the dot) */
+typedef struct Keyword
+{
+   char *name;
+   int length;
+   int kind;  /* the kind of the keyword */
+   int value; /* the index in the instruction table, the register number or the directive id (by the kind) */
+} Keyword;
+
+/* declare a function that returns the keyword of a token with a given length (NULL if its not a keyword) */
+const Keyword *getKeyword(char *, int);
+
+/* define the kinds of keywords */
+#define INSTRUCTION_KEYWORD 1
+#define REGISTER_KEYWORD 2
+#define DIRECTIVE_KEYWORD 3
+
+/* define the directive ids */
+#define DATA_DIRECTIVE_ID 1
+#define STRING_DIRECTIVE_ID 2
+#define ENTRY_DIRECTIVE_ID 3
+#define EXTERN_DIRECTIVE_ID 4
+#define FILL_DIRECTIVE_ID 5
+#define ZERO_DIRECTIVE_ID 6
+#define INCBIN_DIRECTIVE_ID 7
+
+/* define the size of the keyword table (a power of 2) */
+#define KEYWORD_TABLE_SIZE 64
+
+/* define the shortest and the longest keywords ("r0" and "string" / "extern" / "incbin") */
+#define MIN_KEYWORD_LENGTH 2
+#define MAX_KEYWORD_LENGTH 6
+
+/* define the perfect hash of the keywords (takes a token of at least MIN_KEYWORD_LENGTH characters) */
+#define KEYWORD_HASH(token, length) ((7 * (unsigned char)(token)[0] + 41 * (unsigned char)(token)[1] + (length)) & (KEYWORD_TABLE_SIZE - 1))
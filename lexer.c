@@ -0,0 +1,291 @@
+#include "header.h"
+#include "assemble.h"
+#include "instructionsHandler.h"
+#include "keywords.h"
+
+/* the lexer: every line is read once into a token record (its label, its directive or mnemonic and its operands
+   with their addressing methods), so the transitions work on the record instead of scanning the characters again.
+   the line is scanned first into position masks (see scanner.c), and the lexer jumps between the marked positions */
+
+/* function that reads a scanned line into a token record.
+   the errors of the label and the directive are printed here. the errors of an instruction are kept in the record,
+   since they are printed only once its label is added to the symbol table.
+   returns NO_ERROR, or SYNTAX_ERROR if the line can't be used (the error is printed) */
+int tokenizeLine(char *line, LineMasks *masks, LineTokens *tokens, int lineNum)
+{
+    int position;
+    int colon;
+
+    tokens->kind = EMPTY_LINE;
+    tokens->label = NULL;
+    tokens->labelLength = 0;
+    tokens->operandsAmount = 0;
+    tokens->error = NO_ERROR;
+
+    position = findNextClearBit(masks->spaces, 0); /* skip leading white spaces (and the new-line of an empty line) */
+
+    if (position >= masks->length)
+    {
+        return NO_ERROR; /* an empty line */
+    }
+
+    /* the line starts with a label if it has a colon (e.g: LABEL: .data 5) */
+    if ((colon = findNextBit(masks->colons, position)) < masks->length)
+    {
+        /* ensure the name of the label is valid (the error message is printed in the function) */
+        if ((checkLabelName(line + position, colon - position, lineNum)) == SYNTAX_ERROR)
+        {
+            return SYNTAX_ERROR;
+        }
+
+        /* ensure there is a whitespace after the colon */
+        if (!IS_BIT_SET(masks->spaces, colon + 1))
+        {
+            printErrorInLine(MISSING_WHITE_SPACE_AFTER_COLON, lineNum);
+            return SYNTAX_ERROR;
+        }
+
+        tokens->label = line + position;
+        tokens->labelLength = colon - position;
+
+        position = findNextClearBit(masks->spaces, colon + 1); /* skip the white spaces after the colon */
+    }
+
+    if (line[position] == DOT)
+    {
+        return tokenizeDirective(line, masks, position, tokens, lineNum);
+    }
+
+    tokenizeInstruction(line, masks, position, tokens);
+
+    return NO_ERROR;
+}
+
+/* function that reads a directive (e.g: .extern LABEL) from a position of a scanned line into a token record.
+   returns NO_ERROR, or SYNTAX_ERROR (the error is printed) */
+int tokenizeDirective(char *line, LineMasks *masks, int position, LineTokens *tokens, int lineNum)
+{
+    int end = findNextBit(masks->wordEnds, position); /* the end of the directive name */
+    const Keyword *keyword;
+
+    tokens->kind = DIRECTIVE_LINE;
+
+    /* ensure its a directive name (+1 to skip the dot), followed by a white space */
+    keyword = getKeyword(line + position + 1, end - position - 1);
+    if (keyword == NULL || keyword->kind != DIRECTIVE_KEYWORD || !IS_BIT_SET(masks->spaces, end))
+    {
+        printErrorInLine(INVALID_DIRECTIVE_NAME, lineNum, end - position, line + position);
+        return SYNTAX_ERROR;
+    }
+    tokens->directive = keyword->value;
+
+    position = findNextClearBit(masks->spaces, end);
+
+    /* the arguments of .data and .string are coded by their own functions */
+    tokens->arguments = line + position;
+
+    if (tokens->directive == ENTRY_DIRECTIVE_ID || tokens->directive == EXTERN_DIRECTIVE_ID)
+    {
+        Operand *operand = &tokens->operands[0];
+
+        /* the operand is a label, that ends with a white space */
+        end = findNextBit(masks->wordEnds, position);
+
+        /* ensure the name of the label is valid */
+        if ((checkLabelName(line + position, end - position, lineNum)) == SYNTAX_ERROR)
+        {
+            /* the error message would be printed in the function */
+            return SYNTAX_ERROR;
+        }
+
+        operand->start = line + position;
+        operand->length = end - position;
+        operand->addressing = DIRECT_ADDRESSING;
+        operand->value = 0;
+        operand->valueResult = NO_ERROR;
+        tokens->operandsAmount = 1;
+
+        /* ensure no extranous characters after label declaration */
+        if (findNextClearBit(masks->spaces, end) < masks->length)
+        {
+            printErrorInLine(EXTRA_TEXT_AFTER_LABEL_ERROR, lineNum);
+            return SYNTAX_ERROR;
+        }
+    }
+
+    return NO_ERROR;
+}
+
+/* function that reads an instruction (e.g: mov #5, r1) from a position of a scanned line into a token record.
+   an error is kept in the record (the reading stops at the first one) */
+void tokenizeInstruction(char *line, LineMasks *masks, int position, LineTokens *tokens)
+{
+    const Keyword *keyword;
+    int commaFound;
+    int end;
+
+    tokens->kind = INSTRUCTION_LINE;
+
+    /* get the mnemonic */
+    end = findNextBit(masks->wordEnds, position);
+
+    keyword = getKeyword(line + position, end - position);
+    if (keyword == NULL || keyword->kind != INSTRUCTION_KEYWORD)
+    {
+        tokens->error = INVALID_INSTRUCTION;
+        return;
+    }
+    tokens->mnemonic = keyword->value;
+
+    position = findNextClearBit(masks->spaces, end);
+
+    if (position >= masks->length)
+    {
+        return; /* no operands */
+    }
+
+    /* the first operand ends with a white space or a comma */
+    end = findNextBit(masks->operandEnds, position);
+
+    /* a comma before the first operand (an empty operand is an error) */
+    if (end == position)
+    {
+        tokens->error = INVALID_COMMA;
+        return;
+    }
+
+    addOperand(tokens, line + position, end - position);
+    position = end;
+
+    if (position >= masks->length)
+    {
+        return; /* a single operand */
+    }
+
+    commaFound = IS_COMMA(line[position]) != 0;
+    position = findNextClearBit(masks->spaces, position + 1);
+
+    /* check for commas between the operands */
+    while (IS_COMMA(line[position]))
+    {
+        /* check if there are multiple commas (an error) */
+        if (commaFound)
+        {
+            tokens->error = CONSECUTIVE_COMMAS;
+            return;
+        }
+
+        commaFound = TRUE;
+        position = findNextClearBit(masks->spaces, position + 1);
+    }
+
+    if (!commaFound)
+    {
+        /* here, if there is another operand, a comma is missing between the 2 */
+        if (position < masks->length)
+        {
+            tokens->error = MISSING_OPERAND_COMMA;
+        }
+        return;
+    }
+
+    /* a comma without another operand (an error) */
+    if (position >= masks->length)
+    {
+        tokens->error = INVALID_COMMA;
+        return;
+    }
+
+    /* the second operand ends with a white space */
+    end = findNextBit(masks->wordEnds, position);
+
+    addOperand(tokens, line + position, end - position);
+
+    /* check for extra characters */
+    if (findNextClearBit(masks->spaces, end) < masks->length)
+    {
+        tokens->error = EXTRA_CHARACTERS;
+    }
+}
+
+/* function that adds an operand to a token record, with its addressing method and its value */
+void addOperand(LineTokens *tokens, char *start, int length)
+{
+    Operand *operand = &tokens->operands[tokens->operandsAmount++];
+    const Keyword *keyword;
+
+    operand->start = start;
+    operand->length = length;
+    operand->value = 0;
+    operand->valueResult = NO_ERROR;
+
+    if (*start == HASHTAG)
+    {
+        /* +1 to skip the hashtag (an invalid number is reported when the operand is coded) */
+        operand->addressing = IMMEDIATE_ADDRESSING;
+        operand->valueResult = parseNumber(start + 1, length - 1, &operand->value);
+    }
+    else if (*start == AMPERSAND)
+    {
+        operand->addressing = RELATIVE_ADDRESSING;
+    }
+    else if ((keyword = getKeyword(start, length)) != NULL && keyword->kind == REGISTER_KEYWORD)
+    {
+        operand->addressing = DIRECT_REGISTER_ADDRESSING;
+        operand->value = keyword->value; /* the register number */
+    }
+    else
+    {
+        /* if its not one of those, its direct addressing */
+        operand->addressing = DIRECT_ADDRESSING;
+    }
+}
+
+/* function gets a parsed number from a word with a given length */
+int parseNumber(char *word, int length, int *result)
+{
+    int number = 0;         /* init the searched number */
+    int isNegative = FALSE; /* init the isNegative flag */
+    int i = 0;
+
+    if (length == 0)
+    {
+        return MISSING_NUMBER;
+    }
+
+    if (word[i] == NEGATIVE_SIGN || word[i] == POSITIVE_SIGN)
+    {
+        if (word[i] == NEGATIVE_SIGN)
+        {
+            isNegative = TRUE; /* a negative number */
+        }
+        i++; /* move to the next character */
+    }
+
+    /* ensure the word is only digits */
+    for (; i < length; i++)
+    {
+        if (!IS_DIGIT(word[i]))
+        {
+            /* not a number */
+            return INVALID_CHARACTER;
+        }
+
+        number = number * 10 + (word[i] - ZERO_CHAR); /* adjust the number */
+
+        if (number > MAX_NUMBER_MAGNITUDE)
+        {
+            return NUMBER_OUT_OF_RANGE; /* too big for 24 bits, more digits would overflow */
+        }
+    }
+
+    /* get the final number */
+    if (isNegative)
+    {
+        number = -number; /* change to negative */
+    }
+
+    *result = number; /* change the result */
+
+    return NO_ERROR; /* indicate no error */
+}
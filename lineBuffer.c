@@ -0,0 +1,63 @@
+#include "header.h"
+
+/* function that creates an empty line buffer in an arena */
+LineBuffer *initializeLineBuffer(Arena *arena)
+{
+    LineBuffer *buffer = (LineBuffer *)arenaAllocate(arena, sizeof(LineBuffer));
+    if (buffer == NULL)
+    {
+        return NULL;
+    }
+
+    buffer->lines = arenaAllocate(arena, INITIAL_LINES_CAPACITY * sizeof(LineView));
+    if (buffer->lines == NULL)
+    {
+        return NULL;
+    }
+
+    buffer->linesAmount = 0;
+    buffer->linesCapacity = INITIAL_LINES_CAPACITY;
+    buffer->arena = arena;
+
+    return buffer;
+}
+
+/* function that adds a view of a line to the buffer (the line must stay valid as long as the buffer) */
+int addLine(LineBuffer *buffer, char *start, int length)
+{
+    /* ensure there is enough space for the view */
+    if (buffer->linesAmount == buffer->linesCapacity)
+    {
+        LineView *newLines = arenaGrow(buffer->arena, buffer->lines, buffer->linesCapacity * sizeof(LineView), buffer->linesCapacity * 2 * sizeof(LineView));
+        if (newLines == NULL)
+        {
+            return FALSE; /* memory allocation failed */
+        }
+
+        buffer->lines = newLines;
+        buffer->linesCapacity *= 2;
+    }
+
+    buffer->lines[buffer->linesAmount].start = start;
+    buffer->lines[buffer->linesAmount].length = length;
+    buffer->linesAmount++;
+
+    return TRUE;
+}
+
+/* function that returns a line by its index */
+LineView *getLine(LineBuffer *buffer, int index)
+{
+    return &buffer->lines[index];
+}
+
+/* function that writes every line to a file */
+void writeLineBuffer(LineBuffer *buffer, FILE *fp)
+{
+    int i;
+
+    for (i = 0; i < buffer->linesAmount; i++)
+    {
+        fwrite(buffer->lines[i].start, 1, buffer->lines[i].length, fp);
+    }
+}
@@ -0,0 +1,31 @@
+/* define a view of a line (points into the mapped source or into a text allocated in an arena).
+   the length includes the new-line, if the line has one */
+typedef struct LineView
+{
+    char *start;
+    int length;
+} LineView;
+
+/* define a buffer of lines (the pre-assembled code, kept in memory between the pre-assembler and the assembler) */
+typedef struct LineBuffer
+{
+    LineView *lines;
+    int linesAmount;
+    int linesCapacity;
+    Arena *arena; /* the arena of the lines */
+} LineBuffer;
+
+/* declare a function that creates an empty line buffer in an arena (returns NULL on a memory error) */
+LineBuffer *initializeLineBuffer(Arena *);
+
+/* declare a function that adds a view of a line, without copying it (returns FALSE on a memory error) */
+int addLine(LineBuffer *, char *, int);
+
+/* declare a function that returns a line by its index */
+LineView *getLine(LineBuffer *, int);
+
+/* declare a function that writes every line to a file */
+void writeLineBuffer(LineBuffer *, FILE *);
+
+/* define the initial capacity of a line buffer */
+#define INITIAL_LINES_CAPACITY 128
@@ -0,0 +1,160 @@
+#include "header.h"
+#include "preAssembler.h"
+
+/* the macro table: an open addressing hash table (linear probing) that indexes an array of the
+   macros in definition order, so a macro call is found with a single lookup of the line's first word */
+
+/* function that returns the slot of a name: the slot that holds it, or the empty slot it would be placed in */
+static int findSlot(MacroTable *table, char *name, int length, unsigned long hash)
+{
+    int mask = table->slotsCapacity - 1;
+    int slot = (int)(hash & mask);
+
+    while (table->slots[slot] != EMPTY_SLOT)
+    {
+        Macro *macro = &table->macros[table->slots[slot] - 1];
+
+        if (macro->hash == hash && macro->nameLength == length && memcmp(macro->name, name, length) == 0)
+        {
+            break; /* found the name */
+        }
+
+        slot = (slot + 1) & mask; /* try the next slot */
+    }
+
+    return slot;
+}
+
+/* function that doubles the amount of slots and places every macro again (returns FALSE on a memory error) */
+static int growSlots(MacroTable *table)
+{
+    int *slots = allocateSlots(table->arena, table->slotsCapacity * 2);
+    int i;
+
+    if (slots == NULL)
+    {
+        return FALSE;
+    }
+
+    /* the old slots are released with the rest of the arena */
+    table->slots = slots;
+    table->slotsCapacity *= 2;
+
+    for (i = 0; i < table->macrosAmount; i++)
+    {
+        Macro *macro = &table->macros[i];
+        table->slots[findSlot(table, macro->name, macro->nameLength, macro->hash)] = i + 1;
+    }
+
+    return TRUE;
+}
+
+/* function that creates an empty macro table in an arena (returns NULL on a memory error) */
+MacroTable *initializeMacroTable(Arena *arena)
+{
+    MacroTable *table = (MacroTable *)arenaAllocate(arena, sizeof(MacroTable));
+    if (table == NULL)
+    {
+        return NULL;
+    }
+
+    table->macros = NULL;
+    table->macrosAmount = 0;
+    table->macrosCapacity = 0;
+    table->version = 0;
+    memset(table->missedNames, 0, sizeof(table->missedNames));
+    table->arena = arena;
+
+    /* all the slots start empty */
+    table->slotsCapacity = INITIAL_SLOTS_CAPACITY;
+    if ((table->slots = allocateSlots(arena, table->slotsCapacity)) == NULL)
+    {
+        return NULL;
+    }
+
+    return table;
+}
+
+/* function that returns a macro by its name and the name length (NULL if it doesn't exist) */
+Macro *getMacro(MacroTable *table, char *name, int length)
+{
+    int slot;
+
+    /* a longer name can't be a macro */
+    if (length > MAX_MACRO_NAME_LENGTH)
+    {
+        return NULL;
+    }
+
+    slot = findSlot(table, name, length, hashName(name, length));
+
+    return table->slots[slot] == EMPTY_SLOT ? NULL : &table->macros[table->slots[slot] - 1];
+}
+
+/* function that marks a body word that isn't a macro, so defining it later computes the expansions again */
+void addMissedName(MacroTable *table, char *name, int length)
+{
+    unsigned long bit = hashName(name, length) % MISSED_NAMES_BITS;
+
+    table->missedNames[bit / 32] |= 1u << (bit % 32);
+}
+
+/* function that checks if a body word might have been missed by an expansion (a false positive only costs a recomputation) */
+static int isMissedName(MacroTable *table, unsigned long hash)
+{
+    unsigned long bit = hash % MISSED_NAMES_BITS;
+
+    return (table->missedNames[bit / 32] >> (bit % 32)) & 1;
+}
+
+/* add a macro to the table (returns true if successful, false otherwise).
+   the pieces of the template were already allocated in the arena. a macro that is defined again gets the new template */
+int addMacro(MacroTable *table, char *name, MacroTemplate *template)
+{
+    Macro *newMacro;
+    Macro *macros;
+    int length = strlen(name);
+
+    /* check if the macro was already defined */
+    if ((newMacro = getMacro(table, name, length)) != NULL)
+    {
+        /* its old body might be spliced into the expansions of other macros, so they are computed again */
+        table->version++;
+
+        newMacro->template = *template;
+        newMacro->expansionState = EXPANSION_NOT_READY;
+        return TRUE;
+    }
+
+    /* a new name only changes the expansions whose body has a line that starts with it */
+    if (isMissedName(table, hashName(name, length)))
+    {
+        table->version++;
+        memset(table->missedNames, 0, sizeof(table->missedNames)); /* the expansions that are computed again mark them again */
+    }
+
+    /* keep at most half of the slots used */
+    if ((table->macrosAmount + 1) * 2 > table->slotsCapacity && !growSlots(table))
+    {
+        return FALSE; /* memory allocation failed */
+    }
+
+    if ((macros = growArray(table->arena, table->macros, table->macrosAmount, &table->macrosCapacity, sizeof(Macro))) == NULL)
+    {
+        return FALSE; /* memory allocation failed */
+    }
+    table->macros = macros;
+
+    newMacro = &table->macros[table->macrosAmount];
+
+    strcpy(newMacro->name, name); /* copy the name */
+    newMacro->nameLength = length;
+    newMacro->hash = hashName(name, length);
+    newMacro->template = *template;
+    newMacro->expansionState = EXPANSION_NOT_READY;
+
+    table->macrosAmount++;
+    table->slots[findSlot(table, newMacro->name, length, newMacro->hash)] = table->macrosAmount;
+
+    return TRUE;
+}
@@ -0,0 +1,519 @@
+#include "header.h"
+#include "preAssembler.h"
+#include "keywords.h"
+
+/* macro templates: the body of a macro is parsed once, when it is defined, into literal spans of the source
+   and the slots of its parameters. a call only splices its arguments between the spans, without scanning the body again.
+   the calls to other macros in a body are expanded once, on the first call, and the flattened template is kept */
+
+/* function that splits a list of words separated by commas (e.g. p1, p2).
+   returns the amount of words, or SYNTAX_ERROR (the error is printed) */
+int getMacroList(char *text, char **words, int *lengths, int lineNum)
+{
+    int amount = 0;
+
+    skipWhiteSpaces(&text);
+
+    while (*text != NULL_TERMINATOR)
+    {
+        int length = 0;
+
+        /* a word can't be empty (e.g. a, , b) */
+        if (amount > 0)
+        {
+            if (!IS_COMMA(*text))
+            {
+                printErrorInLine(MACRO_LIST_SYNTAX_ERROR, lineNum);
+                return SYNTAX_ERROR;
+            }
+
+            text++; /* skip the comma */
+            skipWhiteSpaces(&text);
+        }
+
+        /* get the length of the word */
+        while (!IS_OPERAND_END(text[length]))
+        {
+            length++;
+        }
+
+        if (length == 0)
+        {
+            printErrorInLine(MACRO_LIST_SYNTAX_ERROR, lineNum);
+            return SYNTAX_ERROR;
+        }
+
+        if (amount == MAX_MACRO_PARAMETERS)
+        {
+            printErrorInLine(MACRO_TOO_MANY_PARAMETERS_ERROR, lineNum, MAX_MACRO_PARAMETERS);
+            return SYNTAX_ERROR;
+        }
+
+        words[amount] = text;
+        lengths[amount] = length;
+        amount++;
+
+        text += length;
+        skipWhiteSpaces(&text);
+    }
+
+    return amount;
+}
+
+/* function that gets the parameters of a macro definition and ensures they are valid names.
+   returns the amount of parameters, or SYNTAX_ERROR (the error is printed) */
+int getMacroParameters(char *text, char **names, int *lengths, int lineNum)
+{
+    int amount = getMacroList(text, names, lengths, lineNum);
+    int i, j;
+
+    for (i = 0; i < amount; i++)
+    {
+        if (lengths[i] > MAX_MACRO_NAME_LENGTH)
+        {
+            printErrorInLine(MACRO_PARAMETER_TOO_BIG_ERROR, lineNum, MAX_MACRO_NAME_LENGTH);
+            return SYNTAX_ERROR;
+        }
+
+        /* start with a letter, and contain only letters, digits and underscore */
+        if (!IS_LABEL_START(names[i][0]))
+        {
+            printErrorInLine(MACRO_INVALID_PARAMETER_ERROR, lineNum, lengths[i], names[i]);
+            return SYNTAX_ERROR;
+        }
+
+        for (j = 1; j < lengths[i]; j++)
+        {
+            if (!IS_NAME_CHAR(names[i][j]))
+            {
+                printErrorInLine(MACRO_INVALID_PARAMETER_ERROR, lineNum, lengths[i], names[i]);
+                return SYNTAX_ERROR;
+            }
+        }
+
+        /* a parameter would replace the keyword in the body */
+        if (getKeyword(names[i], lengths[i]) != NULL)
+        {
+            printErrorInLine(MACRO_PARAMETER_IS_KEYWORD_ERROR, lineNum, lengths[i], names[i]);
+            return SYNTAX_ERROR;
+        }
+
+        /* ensure the parameter wasn't already named */
+        for (j = 0; j < i; j++)
+        {
+            if (lengths[j] == lengths[i] && memcmp(names[j], names[i], lengths[i]) == 0)
+            {
+                printErrorInLine(MACRO_DUPLICATE_PARAMETER_ERROR, lineNum, lengths[i], names[i]);
+                return SYNTAX_ERROR;
+            }
+        }
+    }
+
+    return amount;
+}
+
+/* function that adds a piece to the end of a template */
+static void addMacroPiece(Arena *arena, MacroTemplate *template, char *start, int length, int parameter)
+{
+    MacroPiece *piece;
+
+    template->pieces = growArray(arena, template->pieces, template->piecesAmount, &template->piecesCapacity, sizeof(MacroPiece));
+    if (template->pieces == NULL)
+    {
+        handleMemoryError();
+    }
+
+    piece = &template->pieces[template->piecesAmount++];
+    piece->start = start;
+    piece->length = length;
+    piece->parameter = parameter;
+    piece->endsLine = FALSE;
+}
+
+/* function that parses a body line into pieces: every word that is a parameter name becomes a slot,
+   and the text between them stays a span of the source (no copy) */
+void addMacroLine(Arena *arena, MacroTemplate *template, LineView *line, char **names, int *lengths)
+{
+    char *text = line->start;
+    int literalStart = 0; /* the start of the current literal span */
+    int i = 0;
+
+    while (i < line->length && template->parametersAmount > 0)
+    {
+        int wordLength = 0;
+        int parameter;
+
+        if (!IS_NAME_CHAR(text[i]))
+        {
+            i++;
+            continue;
+        }
+
+        /* get the whole word */
+        while (i + wordLength < line->length && IS_NAME_CHAR(text[i + wordLength]))
+        {
+            wordLength++;
+        }
+
+        /* check if the word is a parameter */
+        for (parameter = 0; parameter < template->parametersAmount; parameter++)
+        {
+            if (lengths[parameter] == wordLength && memcmp(names[parameter], text + i, wordLength) == 0)
+            {
+                break;
+            }
+        }
+
+        if (parameter < template->parametersAmount)
+        {
+            /* close the literal span before the parameter */
+            if (i > literalStart)
+            {
+                addMacroPiece(arena, template, text + literalStart, i - literalStart, LITERAL_PIECE);
+            }
+
+            addMacroPiece(arena, template, NULL, 0, parameter);
+            literalStart = i + wordLength;
+        }
+
+        i += wordLength;
+    }
+
+    /* add the rest of the line (a line without parameters is a single span) */
+    if (line->length > literalStart)
+    {
+        addMacroPiece(arena, template, text + literalStart, line->length - literalStart, LITERAL_PIECE);
+    }
+
+    template->pieces[template->piecesAmount - 1].endsLine = TRUE;
+}
+
+/* function that copies pieces to the end of a template */
+static void copyMacroPieces(Arena *arena, MacroTemplate *template, MacroPiece *pieces, int amount)
+{
+    int i;
+
+    for (i = 0; i < amount; i++)
+    {
+        addMacroPiece(arena, template, pieces[i].start, pieces[i].length, pieces[i].parameter);
+        template->pieces[template->piecesAmount - 1].endsLine = pieces[i].endsLine;
+    }
+}
+
+/* function that returns the macro a body line calls (NULL if its not a call).
+   the offset after the name of the called macro (in the first piece) is returned too */
+static Macro *getBodyCall(MacroTable *table, MacroPiece *line, int *argumentsOffset)
+{
+    Macro *call;
+    int start = 0;
+    int length = 0;
+
+    /* the name of the called macro can't be a parameter */
+    if (line->parameter != LITERAL_PIECE)
+    {
+        return NULL;
+    }
+
+    /* get the first word (a label is not a call) */
+    while (start < line->length && IS_SPACE(line->start[start]))
+    {
+        start++;
+    }
+
+    while (start + length < line->length && !IS_SPACE(line->start[start + length]) && !IS_COLON(line->start[start + length]))
+    {
+        length++;
+    }
+
+    if (length == 0 || (start + length < line->length && IS_COLON(line->start[start + length])))
+    {
+        return NULL;
+    }
+
+    *argumentsOffset = start + length;
+
+    if ((call = getMacro(table, line->start + start, length)) == NULL)
+    {
+        addMissedName(table, line->start + start, length); /* the line is a call if the word is defined later */
+    }
+
+    return call;
+}
+
+/* function that splits the arguments of a call in a macro body. an argument is made of literal spans and the
+   parameters of the calling macro (e.g. #p1), so the parts of every argument are added to a list of pieces.
+   returns the amount of arguments, or SYNTAX_ERROR (the error is printed) */
+static int getBodyCallArguments(Arena *arena, MacroPiece *line, int lineLength, int offset, MacroTemplate *parts, int *firstParts, int *partsAmounts, int lineNum)
+{
+    int amount = 0;
+    int state = BEFORE_ARGUMENT;
+    int i, j;
+
+    for (i = 0; i < lineLength; i++)
+    {
+        int isParameter = line[i].parameter != LITERAL_PIECE;
+        int unitsAmount = isParameter ? 1 : line[i].length; /* a parameter is a single unit of an argument */
+
+        for (j = (i == 0) ? offset : 0; j < unitsAmount; j++)
+        {
+            char current = isParameter ? NULL_TERMINATOR : line[i].start[j];
+            MacroPiece *lastPart;
+
+            if (!isParameter && IS_SPACE(current))
+            {
+                state = state == IN_ARGUMENT ? AFTER_ARGUMENT : state;
+                continue;
+            }
+
+            if (!isParameter && IS_COMMA(current) && state != BEFORE_ARGUMENT)
+            {
+                state = BEFORE_ARGUMENT;
+                continue;
+            }
+
+            /* an empty argument, or a second word without a comma */
+            if ((!isParameter && IS_COMMA(current)) || state == AFTER_ARGUMENT)
+            {
+                printErrorInLine(MACRO_LIST_SYNTAX_ERROR, lineNum);
+                return SYNTAX_ERROR;
+            }
+
+            if (state == BEFORE_ARGUMENT)
+            {
+                if (amount == MAX_MACRO_PARAMETERS)
+                {
+                    printErrorInLine(MACRO_TOO_MANY_PARAMETERS_ERROR, lineNum, MAX_MACRO_PARAMETERS);
+                    return SYNTAX_ERROR;
+                }
+
+                firstParts[amount] = parts->piecesAmount;
+                partsAmounts[amount] = 0;
+                amount++;
+                state = IN_ARGUMENT;
+            }
+
+            /* extend the last literal part when the character follows it */
+            lastPart = partsAmounts[amount - 1] > 0 ? &parts->pieces[parts->piecesAmount - 1] : NULL;
+            if (!isParameter && lastPart != NULL && lastPart->parameter == LITERAL_PIECE && lastPart->start + lastPart->length == line[i].start + j)
+            {
+                lastPart->length++;
+                continue;
+            }
+
+            addMacroPiece(arena, parts, isParameter ? NULL : line[i].start + j, isParameter ? 0 : 1, line[i].parameter);
+            partsAmounts[amount - 1]++;
+        }
+    }
+
+    /* a comma at the end of the arguments */
+    if (state == BEFORE_ARGUMENT && amount > 0)
+    {
+        printErrorInLine(MACRO_LIST_SYNTAX_ERROR, lineNum);
+        return SYNTAX_ERROR;
+    }
+
+    return amount;
+}
+
+/* declare the function that computes the expansion of a macro (the calls in a body are expanded recursively) */
+static int prepareExpansion(MacroTable *, Macro *, int);
+
+/* function that adds the expansion of a call in a macro body to the expansion of the calling macro,
+   with the parts of every argument in place of the parameters of the called macro.
+   returns FALSE if the call is invalid (the error is printed) */
+static int addBodyCall(MacroTable *table, MacroTemplate *expansion, Macro *call, MacroPiece *line, int lineLength, int argumentsOffset, int lineNum)
+{
+    MacroTemplate parts = {NULL, 0, 0, 0};
+    int firstParts[MAX_MACRO_PARAMETERS];
+    int partsAmounts[MAX_MACRO_PARAMETERS];
+    int argumentsAmount;
+    int i;
+
+    /* the called macro is expanded first (this is where a macro that calls itself is found) */
+    if (!prepareExpansion(table, call, lineNum))
+    {
+        return FALSE;
+    }
+
+    argumentsAmount = getBodyCallArguments(table->arena, line, lineLength, argumentsOffset, &parts, firstParts, partsAmounts, lineNum);
+    if (argumentsAmount == SYNTAX_ERROR)
+    {
+        return FALSE;
+    }
+
+    if (argumentsAmount != call->expansion.parametersAmount)
+    {
+        printErrorInLine(MACRO_ARGUMENTS_AMOUNT_ERROR, lineNum, call->name, call->expansion.parametersAmount, argumentsAmount);
+        return FALSE;
+    }
+
+    for (i = 0; i < call->expansion.piecesAmount; i++)
+    {
+        MacroPiece *piece = &call->expansion.pieces[i];
+
+        if (piece->parameter == LITERAL_PIECE)
+        {
+            addMacroPiece(table->arena, expansion, piece->start, piece->length, LITERAL_PIECE);
+        }
+        else
+        {
+            copyMacroPieces(table->arena, expansion, &parts.pieces[firstParts[piece->parameter]], partsAmounts[piece->parameter]);
+        }
+
+        expansion->pieces[expansion->piecesAmount - 1].endsLine = piece->endsLine;
+    }
+
+    return TRUE;
+}
+
+/* function that computes the expansion of a macro: its template, with every body line that calls another macro replaced
+   by the expansion of that macro. the expansion is kept until a macro is defined again, or a body line starts with a new macro.
+   returns FALSE if a macro calls itself or a call is invalid (the error is printed) */
+static int prepareExpansion(MacroTable *table, Macro *macro, int lineNum)
+{
+    MacroTemplate *template = &macro->template;
+    MacroTemplate expansion = {NULL, 0, 0, 0};
+    int copiedAmount = 0; /* the amount of template pieces that were copied to the expansion */
+    int lineStart = 0;    /* the first piece of the current line */
+    int isValid = TRUE;
+    int i;
+
+    if (macro->expansionState == EXPANSION_READY && macro->expansionVersion == table->version)
+    {
+        return TRUE; /* the expansion was already computed */
+    }
+
+    if (macro->expansionState == EXPANSION_IN_PROGRESS)
+    {
+        printErrorInLine(MACRO_CALLS_ITSELF_ERROR, lineNum, macro->name);
+        return FALSE;
+    }
+
+    macro->expansionState = EXPANSION_IN_PROGRESS;
+    expansion.parametersAmount = template->parametersAmount;
+
+    for (i = 0; i < template->piecesAmount && isValid; i++)
+    {
+        int argumentsOffset;
+        Macro *call;
+
+        if (!template->pieces[i].endsLine)
+        {
+            continue; /* the line continues */
+        }
+
+        if ((call = getBodyCall(table, &template->pieces[lineStart], &argumentsOffset)) != NULL)
+        {
+            /* copy the lines before the call as they are */
+            copyMacroPieces(table->arena, &expansion, &template->pieces[copiedAmount], lineStart - copiedAmount);
+            copiedAmount = i + 1;
+
+            isValid = addBodyCall(table, &expansion, call, &template->pieces[lineStart], i - lineStart + 1, argumentsOffset, lineNum);
+        }
+
+        lineStart = i + 1;
+    }
+
+    if (copiedAmount == 0)
+    {
+        macro->expansion = *template; /* there are no calls in the body */
+    }
+    else
+    {
+        copyMacroPieces(table->arena, &expansion, &template->pieces[copiedAmount], template->piecesAmount - copiedAmount);
+        macro->expansion = expansion;
+    }
+
+    macro->expansionState = isValid ? EXPANSION_READY : EXPANSION_NOT_READY;
+    macro->expansionVersion = table->version;
+
+    return isValid;
+}
+
+/* function that expands a macro call: a line that is a single span is added as a view into the source,
+   and a line with parameters is spliced together from its spans and the arguments of the call */
+int expandMacro(MacroTable *table, LineBuffer *output, Macro *macro, char *argumentsText, int lineNum)
+{
+    MacroTemplate *template = &macro->expansion;
+    char *arguments[MAX_MACRO_PARAMETERS];
+    int lengths[MAX_MACRO_PARAMETERS];
+    int argumentsAmount = getMacroList(argumentsText, arguments, lengths, lineNum);
+    int result = NO_ERROR;
+    int lineStart = 0; /* the first piece of the current line */
+    int i, j;
+
+    if (argumentsAmount == SYNTAX_ERROR || !prepareExpansion(table, macro, lineNum))
+    {
+        return SYNTAX_ERROR; /* the error was already printed */
+    }
+
+    if (argumentsAmount != template->parametersAmount)
+    {
+        printErrorInLine(MACRO_ARGUMENTS_AMOUNT_ERROR, lineNum, macro->name, template->parametersAmount, argumentsAmount);
+        return SYNTAX_ERROR;
+    }
+
+    for (i = 0; i < template->piecesAmount; i++)
+    {
+        MacroPiece *pieces = template->pieces;
+        char *expandedLine;
+        int length = 0;
+
+        if (!pieces[i].endsLine)
+        {
+            continue; /* the line continues */
+        }
+
+        if (i == lineStart && pieces[i].parameter == LITERAL_PIECE)
+        {
+            /* no parameters in the line, add it as it is */
+            expandedLine = pieces[i].start;
+            length = pieces[i].length;
+        }
+        else
+        {
+            /* get the length of the expanded line */
+            for (j = lineStart; j <= i; j++)
+            {
+                length += pieces[j].parameter == LITERAL_PIECE ? pieces[j].length : lengths[pieces[j].parameter];
+            }
+
+            if ((expandedLine = arenaAllocate(output->arena, length)) == NULL)
+            {
+                handleMemoryError();
+            }
+
+            /* splice the spans and the arguments */
+            length = 0;
+            for (j = lineStart; j <= i; j++)
+            {
+                if (pieces[j].parameter == LITERAL_PIECE)
+                {
+                    memcpy(expandedLine + length, pieces[j].start, pieces[j].length);
+                    length += pieces[j].length;
+                }
+                else
+                {
+                    memcpy(expandedLine + length, arguments[pieces[j].parameter], lengths[pieces[j].parameter]);
+                    length += lengths[pieces[j].parameter];
+                }
+            }
+
+            /* the assembler reads lines of at most MAX_LINE_LENGTH characters */
+            if (length > MAX_LINE_LENGTH)
+            {
+                printErrorInLine(MACRO_EXPANSION_TOO_BIG_ERROR, lineNum, macro->name, MAX_LINE_LENGTH);
+                result = SYNTAX_ERROR;
+            }
+        }
+
+        if (!addLine(output, expandedLine, length))
+        {
+            handleMemoryError();
+        }
+
+        lineStart = i + 1;
+    }
+
+    return result;
+}
@@ -0,0 +1,216 @@
+#include "header.h"
+
+/* the output writer: the records of the output files are formatted with digit tables into a large buffer,
+   which is written with a single write call whenever it fills up. the text is the same as printed with
+   fprintf("%s %07d\n"). the records of the object file ("%07d %06x\n") have a fixed length, so they are
+   formatted straight into the mapped object file.
+   the output is compared with the existing file as its flushed, and only once it differs the temporary file
+   is created (with the part that was the same) - so an unchanged file is only read */
+
+/* the decimal digits of the numbers 00 to 99 (2 digits are formatted at once) */
+static const char decimalPairs[] =
+    "0001020304050607080910111213141516171819"
+    "2021222324252627282930313233343536373839"
+    "4041424344454647484950515253545556575859"
+    "6061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+/* the hexadecimal digits */
+static const char hexDigits[] = "0123456789abcdef";
+
+/* function that writes the part of the existing file that is the same as the output to the temporary file
+   (once the output differs from it) */
+static void writeComparedOutput(OutputWriter *writer)
+{
+    char *existingData = writer->file.existing != NULL ? writer->file.existing->data : NULL;
+
+    if (!writeOutputFile(&writer->file, existingData, writer->compared))
+    {
+        writer->isError = TRUE;
+    }
+}
+
+/* function that writes the buffer to the file (or compares it with the existing file, while its the same) */
+static void flushOutputWriter(OutputWriter *writer)
+{
+    SourceFile *existing = writer->file.existing;
+
+    if (writer->file.fd == -1 && !writer->isError)
+    {
+        if (existing != NULL && writer->compared + writer->used <= existing->size &&
+            memcmp(existing->data + writer->compared, writer->buffer, writer->used) == 0)
+        {
+            writer->compared += writer->used;
+            writer->used = 0;
+            return; /* the same so far */
+        }
+
+        writeComparedOutput(writer);
+    }
+
+    if (!writer->isError && !writeOutputFile(&writer->file, writer->buffer, writer->used))
+    {
+        writer->isError = TRUE; /* the rest of the output is dropped */
+    }
+
+    writer->used = 0;
+}
+
+/* function that returns room for some bytes at the end of the buffer (flushes it if they don't fit) */
+static char *reserveOutput(OutputWriter *writer, int amount)
+{
+    char *room;
+
+    if (writer->used + amount > OUTPUT_BUFFER_SIZE)
+    {
+        flushOutputWriter(writer);
+    }
+
+    room = writer->buffer + writer->used;
+    writer->used += amount;
+
+    return room;
+}
+
+/* function that formats the digits of a number, right to left, before a given end (returns the first digit) */
+static char *formatDigits(char *end, unsigned long number)
+{
+    while (number >= 100)
+    {
+        int pair = (int)(number % 100) * 2;
+
+        number /= 100;
+        *--end = decimalPairs[pair + 1];
+        *--end = decimalPairs[pair];
+    }
+
+    if (number >= 10)
+    {
+        *--end = decimalPairs[number * 2 + 1];
+        *--end = decimalPairs[number * 2];
+    }
+    else
+    {
+        *--end = (char)('0' + number);
+    }
+
+    return end;
+}
+
+/* function that prepares an output writer (its file is prepared by itself) */
+void initializeOutputWriter(OutputWriter *writer)
+{
+    writer->compared = 0;
+    writer->used = 0;
+    writer->isError = FALSE;
+}
+
+/* function that adds a text with a given length to the output */
+void writeText(OutputWriter *writer, char *text, int length)
+{
+    /* a text that is longer than the buffer is written in parts */
+    while (length > 0)
+    {
+        int part = length < OUTPUT_BUFFER_SIZE ? length : OUTPUT_BUFFER_SIZE;
+
+        memcpy(reserveOutput(writer, part), text, part);
+        text += part;
+        length -= part;
+    }
+}
+
+/* function that adds a decimal number to the output, padded to a width (as printed with "%7d" or "%07d") */
+void writeDecimal(OutputWriter *writer, int number, int width, char padding)
+{
+    char digits[MAX_NUMBER_DIGITS];
+    char *end = digits + MAX_NUMBER_DIGITS;
+    char *start = formatDigits(end, number < 0 ? 0UL - (unsigned long)number : (unsigned long)number);
+    int length = (int)(end - start) + (number < 0);
+    char *room = reserveOutput(writer, (length > width ? length : width));
+
+    /* spaces come before the sign, zeros after it */
+    if (padding != '0')
+    {
+        for (; length < width; width--)
+        {
+            *room++ = padding;
+        }
+    }
+
+    if (number < 0)
+    {
+        *room++ = '-';
+    }
+
+    for (; length < width; width--)
+    {
+        *room++ = '0';
+    }
+
+    memcpy(room, start, end - start);
+}
+
+/* function that adds a number to the output as an amount of little-endian bytes (of the binary object file) */
+void writeLittleEndian(OutputWriter *writer, unsigned long number, int bytes)
+{
+    char *room = reserveOutput(writer, bytes);
+    int i;
+
+    for (i = 0; i < bytes; i++)
+    {
+        room[i] = (char)(number & 0xFF);
+        number >>= 8;
+    }
+}
+
+/* function that formats a record of the object file into OBJECT_RECORD_LENGTH bytes
+   ("%07d %06x\n" of the address and the word, the address is at most MAX_RECORD_ADDRESS) */
+void formatObjectRecord(char *record, int address, int word)
+{
+    int i;
+
+    /* the address, 2 digits at a time from the right (the first digit is left alone) */
+    for (i = ADDRESS_DIGITS - 2; i > 0; i -= 2)
+    {
+        int pair = (address % 100) * 2;
+
+        address /= 100;
+        record[i] = decimalPairs[pair];
+        record[i + 1] = decimalPairs[pair + 1];
+    }
+    record[0] = (char)('0' + address);
+    record[ADDRESS_DIGITS] = ' ';
+
+    /* the word, a hexadecimal digit for every 4 bits */
+    for (i = ADDRESS_DIGITS + WORD_DIGITS; i > ADDRESS_DIGITS; i--)
+    {
+        record[i] = hexDigits[word & 0xF];
+        word >>= 4;
+    }
+    record[OBJECT_RECORD_LENGTH - 1] = NEW_LINE;
+}
+
+/* function that adds a record of the entry or external file to the output ("%s %07d\n" of the symbol and the address) */
+void writeSymbolRecord(OutputWriter *writer, char *symbol, int address)
+{
+    writeText(writer, symbol, strlen(symbol));
+    writeText(writer, " ", 1);
+    writeDecimal(writer, address, ADDRESS_DIGITS, '0');
+    writeText(writer, "\n", 1);
+}
+
+/* function that writes the rest of the buffer and closes the file, leaving the existing file as it is
+   if the content didn't change (returns FALSE if writing failed) */
+int closeOutputWriter(OutputWriter *writer)
+{
+    flushOutputWriter(writer);
+
+    /* an output that is shorter than the existing file (or that there is no existing file for) still changed it */
+    if (writer->file.fd == -1 && !writer->isError &&
+        (writer->file.existing == NULL || writer->compared != writer->file.existing->size))
+    {
+        writeComparedOutput(writer);
+    }
+
+    return closeOutputFile(&writer->file, writer->isError);
+}
@@ -0,0 +1,58 @@
+/* define the size of the buffer of an output writer (flushed with a single write when it fills up) */
+#define OUTPUT_BUFFER_SIZE 65536
+
+/* define the longest formatted number (a sign and the digits of an int) */
+#define MAX_NUMBER_DIGITS 12
+
+/* define the widths of the numbers of the output files (as in "%07d %06x") */
+#define ADDRESS_DIGITS 7
+#define WORD_DIGITS 6
+
+/* define the length of a record of the object file (the address, a space, the word and a new-line) */
+#define OBJECT_RECORD_LENGTH (ADDRESS_DIGITS + WORD_DIGITS + 2)
+
+/* define the largest address that fits in a record of the object file */
+#define MAX_RECORD_ADDRESS 9999999
+
+/* define an output file - written to a temporary file that replaces the existing file, only if the content changed */
+typedef struct OutputFile
+{
+   char *path;                  /* the path of the output file */
+   char *tempPath;              /* the path of the temporary file (NULL until its created) */
+   int fd;                      /* the temporary file (-1 until its created) */
+   struct SourceFile *existing; /* the existing file, mapped (NULL if there is none) */
+} OutputFile;
+
+/* define an output writer - formats the records of an output file into a buffer, instead of a fprintf for each.
+   while the content is the same as the existing file, nothing is written */
+typedef struct OutputWriter
+{
+   OutputFile file;                 /* the output file (prepared before the writer is used) */
+   int compared;                    /* the amount of bytes that are the same as the existing file (until its changed) */
+   int used;                        /* the amount of bytes in the buffer */
+   int isError;                     /* flag if writing to the file failed */
+   char buffer[OUTPUT_BUFFER_SIZE];
+} OutputWriter;
+
+/* declare a function that prepares an output writer (its file is prepared by itself) */
+void initializeOutputWriter(OutputWriter *);
+
+/* declare a function that adds a text with a given length to the output */
+void writeText(OutputWriter *, char *, int);
+
+/* declare a function that adds a decimal number to the output (takes the number, the width and the padding character) */
+void writeDecimal(OutputWriter *, int, int, char);
+
+/* declare a function that adds a number to the output as an amount of little-endian bytes (of the binary object file) */
+void writeLittleEndian(OutputWriter *, unsigned long, int);
+
+/* declare a function that formats a record of the object file into OBJECT_RECORD_LENGTH bytes
+   ("%07d %06x\n" of the address and the word, the address is at most MAX_RECORD_ADDRESS) */
+void formatObjectRecord(char *, int, int);
+
+/* declare a function that adds a record of the entry or external file to the output ("%s %07d\n" of the symbol and the address) */
+void writeSymbolRecord(OutputWriter *, char *, int);
+
+/* declare a function that writes the rest of the buffer and closes the file, leaving the existing file as it is
+   if the content didn't change (returns FALSE if writing failed) */
+int closeOutputWriter(OutputWriter *);
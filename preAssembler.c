@@ -1,26 +1,56 @@
 #include "header.h"
 #include "preAssembler.h"
+#include "fileHandler.h"
+#include "keywords.h"
 
 /* the pre assembler */
-int preAssembler(FILE *fp, FILE *outputFilePointer)
+int preAssembler(SourceFile *source, char *filename, LineBuffer *output)
 {
-    MacroNode *macroHead = NULL;   /* initialize macro head */
-    MacroNode **head = &macroHead; /* pointer to the macro head */
-
-    char line[MAX_LINE_LENGTH + 1];        /* intialize the line buffer (+1 for \n) */
-    int onMcro = FALSE;                    /* flag if a macro is on */
-    char macroName[MAX_MACRO_NAME_LENGTH]; /* initialize a macro name */
-    char *macroDefinition = NULL;          /* initialize a macro definition */
-    int macroDefSize = INITIAL_DEF_SIZE;   /* initialize the size of the macro definition */
-    int isError = FALSE;                   /* initialize the error flag */
-    int lineNum = 0;                       /* initialize the line number */
-
-    while (fgets(line, MAX_LINE_LENGTH + 1, fp) != NULL) /* +1 to check for overflowing lines */
+    Arena *arena = output->arena;                     /* the macros are allocated with the lines */
+    MacroTable *macros = initializeMacroTable(arena); /* initialize the macro table */
+    IncludeGuards guards = {NULL, 0, 0};              /* initialize the include guards */
+    char *path;                                       /* initialize the path of the file */
+
+    if (macros == NULL || (path = arenaAllocate(arena, strlen(filename) + strlen(ASSEMBLY_FILE_EXTENTION) + 1)) == NULL)
+    {
+        handleMemoryError();
+    }
+
+    /* the file guards itself, so including it again does nothing */
+    strcpy(path, filename);
+    strcat(path, ASSEMBLY_FILE_EXTENTION);
+    addIncludeGuard(arena, &guards, path);
+
+    return preAssembleLines(source, output, macros, &guards, NULL);
+}
+
+/* pre-assembles the lines of a source file: spreads the macros and the included files, and skips the comments.
+   an included file is parsed on its own (self is the included file, and NULL for an assembly file) */
+int preAssembleLines(SourceFile *source, LineBuffer *output, MacroTable *macros, IncludeGuards *guards, IncludedFile *self)
+{
+    Arena *arena = output->arena;                     /* the macros are allocated with the lines */
+
+    char line[MAX_LINE_LENGTH + 1];                   /* intialize the line buffer (+1 for \0) */
+    LineView sourceLine;                              /* initialize the view of the line in the source */
+    int sourceOffset = 0;                             /* initialize the offset of the next line in the source */
+    int onMcro = FALSE;                               /* flag if a macro is on */
+    int isValidMacro = FALSE;                         /* flag if the current macro can be added to the table */
+    char macroName[MAX_MACRO_NAME_LENGTH + 1];        /* initialize a macro name (+1 for \0) */
+    MacroTemplate macroTemplate = {NULL, 0, 0, 0};    /* initialize the template of a macro body */
+    char *parameters[MAX_MACRO_PARAMETERS];           /* initialize the names of the macro parameters (in the source) */
+    int parameterLengths[MAX_MACRO_PARAMETERS];       /* initialize the lengths of the parameter names */
+    int isError = FALSE;                              /* initialize the error flag */
+    int lineNum = 0;                                  /* initialize the line number */
+
+    while (readSourceLine(source, &sourceOffset, &sourceLine))
     {
         /* initialize the macro call */
-        char *macroCall = NULL;
-        MacroNode *currentMacro = *head;
-        int lineLength = strlen(line);
+        Macro *macroCall = NULL;
+        int firstWordLength;
+        int lineLength = sourceLine.length;
+
+        /* scan a copy of at most MAX_LINE_LENGTH characters (longer lines are an error) */
+        int scannedLength = lineLength > MAX_LINE_LENGTH ? MAX_LINE_LENGTH : lineLength;
 
         char *currentLine = line; /* initialize a pointer to the current character in line */
 
@@ -28,8 +58,11 @@ int preAssembler(FILE *fp, FILE *outputFilePointer)
 
         lineNum++; /* increment the line number */
 
+        memcpy(line, sourceLine.start, scannedLength);
+        line[scannedLength] = NULL_TERMINATOR;
+
         /* if its a comment line, skip it */
-        if (*currentLine == COMMENT_CHAR)
+        if (IS_COMMENT(*currentLine))
         {
             continue;
         }
@@ -51,28 +84,54 @@ int preAssembler(FILE *fp, FILE *outputFilePointer)
             /* find the position of where the macro name starts */
             char *macroStart = currentLine + MACRO_START_LENGTH;
             int macroNameLength; /* initialize the length of a macro name */
+            char *parametersStart; /* initialize the position of the parameters */
 
             /* skip white spaces after mcro */
             skipWhiteSpaces(&macroStart);
 
             /* calculate the length of a macro name */
-            macroNameLength = strcspn(macroStart, WHITE_SPACES);
+            macroNameLength = 0;
+            while (!IS_WORD_END(macroStart[macroNameLength]))
+            {
+                macroNameLength++;
+            }
 
             /* check if the macro name is too big */
             if (macroNameLength > MAX_MACRO_NAME_LENGTH)
             {
                 printErrorInLine(MACRO_NAME_TOO_BIG_ERROR, lineNum, MAX_MACRO_NAME_LENGTH);
-                isError = TRUE; /* set the error flag */
+                isError = TRUE;                           /* set the error flag */
+                macroNameLength = MAX_MACRO_NAME_LENGTH; /* keep only the start of the name */
             }
 
-            /* get the macro name */
-            strcpy(macroName, macroStart);
+            /* get the macro name (the parameters follow it) */
+            parametersStart = macroStart + macroNameLength;
+            strncpy(macroName, macroStart, macroNameLength);
             macroName[macroNameLength] = NULL_TERMINATOR; /* remove the new line */
 
             onMcro = TRUE; /* set the onMcro flag to true */
 
+            /* get the parameters that follow the name (e.g. mcro name p1, p2) */
+            macroTemplate.parametersAmount = getMacroParameters(parametersStart, parameters, parameterLengths, lineNum);
+            if (macroTemplate.parametersAmount == SYNTAX_ERROR)
+            {
+                isError = TRUE;                   /* the error was already printed */
+                macroTemplate.parametersAmount = 0; /* keep the body as it is */
+            }
+            else
+            {
+                int i;
+
+                /* the line is overwritten by the next one, so keep the names as spans of the source */
+                for (i = 0; i < macroTemplate.parametersAmount; i++)
+                {
+                    parameters[i] = sourceLine.start + (parameters[i] - line);
+                }
+            }
+
             /* check if the macro name is an instruction name (the function also prints the error) */
-            if (!isValidMacroName(macroName, lineNum))
+            isValidMacro = isValidMacroName(macroName, lineNum);
+            if (!isValidMacro)
             {
                 /* printing the error was already handled */
                 isError = TRUE; /* set the error flag */
@@ -94,17 +153,19 @@ int preAssembler(FILE *fp, FILE *outputFilePointer)
             if (macroEndResult == NO_ERROR)
             {
                 onMcro = FALSE; /* set the flag to false */
-                macroDefSize = INITIAL_DEF_SIZE /* reset the size of the macro definition */;
 
-                if (addMacro(head, macroName, macroDefinition) == FALSE) /* add the macro to the list */
+                /* add the macro to the table (a macro with an invalid name is dropped, so its calls aren't expanded) */
+                if (isValidMacro && addMacro(macros, macroName, &macroTemplate) == FALSE)
                 {
                     /* a memory allocation error was found */
-                    customHandleMemoryError(fp, head);
+                    handleMemoryError();
                 }
 
-                /* reset the macro definition and macro name after adding the macro */
-                free(macroDefinition);
-                macroDefinition = NULL;
+                /* reset the macro template and macro name after adding the macro (the pieces are owned by the macro) */
+                macroTemplate.pieces = NULL;
+                macroTemplate.piecesAmount = 0;
+                macroTemplate.piecesCapacity = 0;
+                macroTemplate.parametersAmount = 0;
                 strcpy(macroName, EMPTY_STRING);
             }
             else if (macroEndResult == EXTRANOUS_CHARACTERS)
@@ -114,33 +175,8 @@ int preAssembler(FILE *fp, FILE *outputFilePointer)
             }
             else
             {
-                /* add the current line to macro definition (reallocate memory) */
-
-                if (!macroDefinition)
-                {
-                    /* initialize the macro definition */
-                    macroDefinition = malloc(lineLength + 1);
-                    if (!macroDefinition)
-                    {
-                        customHandleMemoryError(fp, head);
-                    }
-
-                    strcpy(macroDefinition, line); /* add the line to the macro definition */
-                    macroDefSize = lineLength;     /* update the size of the macro definition */
-                }
-                else
-                {
-                    /* reallocate memory for the macro definition */
-                    macroDefinition = realloc(macroDefinition, macroDefSize + lineLength + 1);
-                    if (!macroDefinition)
-                    {
-                        customHandleMemoryError(fp, head);
-                    }
-
-                    strcat(macroDefinition, line); /* add the line to the macro definition */
-                }
-
-                macroDefSize += lineLength; /* update the size of the macro definition */
+                /* parse the current line into the macro template (its text stays in the source) */
+                addMacroLine(arena, &macroTemplate, &sourceLine, parameters, parameterLengths);
             }
 
             continue; /* dont write any code */
@@ -148,108 +184,57 @@ int preAssembler(FILE *fp, FILE *outputFilePointer)
 
         /* not inside a macro and not a macro start */
 
-        /* check if the line contains a macro call */
-        while (currentMacro)
+        /* check if the line includes a file (e.g. .include "prelude.as") */
+        if (STARTS_WITH_INCLUDE(currentLine))
         {
-            char *foundMacro = strstr(line, currentMacro->name); /* get the macro */
-
-            if (foundMacro != NULL)
+            if (handleInclude(currentLine + INCLUDE_DIRECTIVE_LENGTH, output, macros, guards, self, lineNum) != NO_ERROR)
             {
-                int macroLength = strlen(currentMacro->name); /* get the length of the macro */
-                /* ensure it actually is a macro (the word ends here) */
-                if (isspace(foundMacro[macroLength]) || foundMacro[macroLength] == NULL_TERMINATOR)
-                {
-                    macroCall = foundMacro; /* found the macro call */
+                isError = TRUE; /* the error was already printed */
+            }
 
-                    break; /* found the macro call */
-                }
+            continue;
+        }
 
-                /* ensure its not also a label */
-                if (foundMacro[macroLength] == COLON)
-                {
-                    printErrorInLine(MACRO_NAME_IS_LABEL_ERROR, lineNum, macroLength, currentLine);
-                    isError = TRUE; /* set the error flag */
-                }
-            }
-            currentMacro = currentMacro->next;
+        /* check if the line is a macro call (its first word is a macro name) */
+        firstWordLength = 0;
+        while (!IS_WORD_END(currentLine[firstWordLength]) && !IS_COLON(currentLine[firstWordLength]))
+        {
+            firstWordLength++;
         }
 
-        if (macroCall)
+        if (IS_COLON(currentLine[firstWordLength]))
         {
-            /* write the parts with the macro definition to the output file */
-            fprintf(outputFilePointer, "%s", currentMacro->definition);
+            /* ensure a label is not also a macro name */
+            if (getMacro(macros, currentLine, firstWordLength) != NULL)
+            {
+                printErrorInLine(MACRO_NAME_IS_LABEL_ERROR, lineNum, firstWordLength, currentLine);
+                isError = TRUE; /* set the error flag */
+            }
         }
         else
         {
-            /* no macro call founds, write the line as it is */
-            fputs(line, outputFilePointer);
+            macroCall = getMacro(macros, currentLine, firstWordLength);
         }
-    }
-
-    rewind(outputFilePointer); /* rewind the output file pointer */
-
-    freeMacroList(head); /* free the macro list */
-
-    return isError; /* return the final error state */
-}
-
-/* add a macro to the list (returns true if successful, false otherwise) */
-int addMacro(MacroNode **head, char *name, char *definition)
-{
-    MacroNode *newNode = malloc(sizeof(MacroNode)); /* create a new macro */
-    if (!newNode)
-    {
-        return FALSE; /* memory allocation failed */
-    }
-
-    strcpy(newNode->name, name); /* copy the name */
 
-    /* copy the definition */
-    if (definition == NULL)
-    {
-        /* handle case when definition is empty */
-        newNode->definition = malloc(1); /* allocate memory for a single charater (the null-terminator) */
-        if (!newNode->definition)
+        if (macroCall)
         {
-            free(newNode); /* free the allocated node */
-            return FALSE;  /* indicate memory allocation error */
+            /* add the lines of the macro to the output, with the arguments that follow its name */
+            if (expandMacro(macros, output, macroCall, currentLine + firstWordLength, lineNum) != NO_ERROR)
+            {
+                isError = TRUE; /* the error was already printed */
+            }
         }
-        newNode->definition[0] = NULL_TERMINATOR; /* set the null terminator10 */
-    }
-    else
-    {
-        newNode->definition = malloc(strlen(definition) + 1);
-        if (newNode->definition)
+        else
         {
-            strcpy(newNode->definition, definition);
+            /* no macro call founds, add the line as it is (a view into the source, no copy) */
+            if (!addLine(output, sourceLine.start, lineLength))
+            {
+                handleMemoryError();
+            }
         }
     }
 
-    if (!newNode->definition)
-    {
-        return FALSE; /* memory allocation failed */
-    }
-
-    newNode->next = *head; /* point to the current head */
-
-    *head = newNode; /* update the head of the list */
-
-    return TRUE;
-}
-
-/* frees the allocated memory for the macro table */
-void freeMacroList(MacroNode **head)
-{
-    MacroNode *current = *head;
-    while (current)
-    {
-        MacroNode *temp = current;
-        current = current->next;
-
-        /* free the alocated memory of this node */
-        free(temp->definition);
-        free(temp);
-    }
+    return isError; /* return the final error state */
 }
 
 /* check if a macro starts */
@@ -264,7 +249,7 @@ int isMacroStart(char *line)
     }
 
     /* skip the first word */
-    while (!isspace(*line) && *line != NULL_TERMINATOR)
+    while (!IS_WORD_END(*line))
     {
         line++;
     }
@@ -272,24 +257,8 @@ int isMacroStart(char *line)
 
     if (foundMacroStart)
     {
-        /* ensure there where no extra characters */
-
-        /* skip the macro name */
-        while (!isspace(*line))
-        {
-            line++;
-        }
-        skipWhiteSpaces(&line);
-
-        /* check if there are extra characters */
-        if (*line != NULL_TERMINATOR)
-        {
-            return EXTRANOUS_CHARACTERS;
-        }
-        else
-        {
-            return NO_ERROR;
-        }
+        /* the text after the macro name is its parameters (checked when they are read) */
+        return NO_ERROR;
     }
     else
     {
@@ -297,7 +266,7 @@ int isMacroStart(char *line)
         while (*line != NULL_TERMINATOR)
         {
             /* skip commas */
-            if (*line == COMMA)
+            if (IS_COMMA(*line))
             {
                 line++;
                 skipWhiteSpaces(&line);
@@ -310,7 +279,7 @@ int isMacroStart(char *line)
             }
 
             /* skip word */
-            while (!isspace(*line) && *line != NULL_TERMINATOR)
+            while (!IS_WORD_END(*line))
             {
                 line++;
             }
@@ -333,7 +302,7 @@ int isMacroEnd(char *line)
     }
 
     /* skip the first word */
-    while (!isspace(*line) && *line != NULL_TERMINATOR)
+    while (!IS_WORD_END(*line))
     {
         line++;
     }
@@ -359,7 +328,7 @@ int isMacroEnd(char *line)
         while (*line != NULL_TERMINATOR)
         {
             /* skip commas */
-            if (*line == COMMA)
+            if (IS_COMMA(*line))
             {
                 line++;
                 skipWhiteSpaces(&line);
@@ -372,7 +341,7 @@ int isMacroEnd(char *line)
             }
 
             /* skip word */
-            while (!isspace(*line) && *line != NULL_TERMINATOR)
+            while (!IS_WORD_END(*line))
             {
                 line++;
             }
@@ -386,39 +355,32 @@ int isMacroEnd(char *line)
 /* checks if a word is a valid macro name */
 int isValidMacroName(char *word, int lineNum)
 {
-    int i;
     char *tracker = word;
+    const Keyword *keyword = getKeyword(word, strlen(word)); /* find the word in the keyword table */
 
-    /* check if its an instruction name */
-    if (IS_INSTRUCTION(word))
-    {
-        printErrorInLine(MACRO_IS_INSTRUCTION_ERROR, lineNum, word);
-        return FALSE;
-    }
-
-    /* check if its a register */
-    for (i = 0; i < REGISTERS_AMOUNT; i++)
+    /* check if its an instruction, register or directive name */
+    if (keyword != NULL)
     {
-        char registerName[REGISTER_LENGTH];
-        sprintf(registerName, "r%d", i);
-        if (strcmp(word, registerName) == 0)
+        switch (keyword->kind)
         {
-            printErrorInLine(MACRO_IS_REGISTER_ERROR, lineNum, registerName);
-            return FALSE;
+        case INSTRUCTION_KEYWORD:
+            printErrorInLine(MACRO_IS_INSTRUCTION_ERROR, lineNum, word);
+            break;
+        case REGISTER_KEYWORD:
+            printErrorInLine(MACRO_IS_REGISTER_ERROR, lineNum, word);
+            break;
+        case DIRECTIVE_KEYWORD:
+            printErrorInLine(MACRO_IS_DIRECTIVE_ERROR, lineNum, word);
+            break;
         }
-    }
 
-    /* check if the word is a directive name */
-    if (IS_DIRECTIVE(word))
-    {
-        printErrorInLine(MACRO_IS_DIRECTIVE_ERROR, lineNum, word);
         return FALSE;
     }
 
     /* check for valid syntax */
 
     /* start with a letter */
-    if (!isalpha(*word))
+    if (!IS_LABEL_START(*word))
     {
         printErrorInLine(MACRO_INVALID_NAME_START, lineNum, word);
         return FALSE;
@@ -428,7 +390,7 @@ int isValidMacroName(char *word, int lineNum)
     tracker++; /* already checked the first character */
     while (*tracker)
     {
-        if (!isalnum(*tracker) && *tracker != UNDERSCORE)
+        if (!IS_NAME_CHAR(*tracker))
         {
             printErrorInLine(MACRO_CONTAINS_INVALID_CHAR, lineNum, word);
             return FALSE;
@@ -438,12 +400,3 @@ int isValidMacroName(char *word, int lineNum)
 
     return TRUE; /* otherwise its a valid name */
 }
-
-/* a function that frees the allocated data before handling a memory error */
-void customHandleMemoryError(FILE *fp, MacroNode **head)
-{
-    fclose(fp);          /* close the file */
-    freeMacroList(head); /* free the allocated memory for the macro list */
-
-    handleMemoryError();
-}
@@ -1,14 +1,112 @@
+/* define the size of the filter of the body words that weren't macros (MISSED_NAMES_WORDS words of 32 bits) */
+#define MISSED_NAMES_WORDS 32
+#define MISSED_NAMES_BITS (MISSED_NAMES_WORDS * 32)
+
+/* define a piece of a macro body: a literal span of the source, or the slot of a parameter */
+typedef struct MacroPiece
+{
+   char *start;   /* the start of the literal span in the source (unused for a parameter) */
+   int length;    /* the length of the literal span */
+   int parameter; /* the index of the parameter that replaces the piece (LITERAL_PIECE for a literal span) */
+   int endsLine;  /* flag if the piece is the last one of a body line */
+} MacroPiece;
+
+/* define a macro template - the body of a macro, parsed once into pieces when the macro is defined */
+typedef struct MacroTemplate
+{
+   MacroPiece *pieces; /* the pieces of the body lines, in order */
+   int piecesAmount;
+   int piecesCapacity;
+   int parametersAmount;
+} MacroTemplate;
+
 /* define a macro struct */
-typedef struct MacroNode
+typedef struct Macro
 {
    char name[MAX_MACRO_NAME_LENGTH + 1]; /* including the null-terminator */
-   char *definition;
-   struct MacroNode *next;
-} MacroNode;
+   int nameLength;
+   unsigned long hash;      /* the hash of the name */
+   MacroTemplate template;  /* the parsed body of the macro */
+   MacroTemplate expansion; /* the body with the calls to other macros expanded (computed on the first call) */
+   int expansionState;      /* the state of the expansion (EXPANSION_NOT_READY, EXPANSION_IN_PROGRESS or EXPANSION_READY) */
+   int expansionVersion;    /* the version of the table the expansion was computed with */
+} Macro;
+
+/* define the macro table - an open addressing hash table that indexes the macros in definition order */
+typedef struct MacroTable
+{
+   Macro *macros;     /* the macros in definition order */
+   int macrosAmount;
+   int macrosCapacity;
+   int *slots;        /* the hash slots (the index of a macro + 1, or EMPTY_SLOT) */
+   int slotsCapacity; /* always a power of 2 */
+   int version;       /* changes whenever a macro is defined that can change the expansions */
+   unsigned int missedNames[MISSED_NAMES_WORDS]; /* a filter of the body words that weren't macros when expanded */
+   Arena *arena;      /* the arena of the macros */
+} MacroTable;
+
+/* define the include guards of a file - the paths of the files that were already included in it */
+typedef struct IncludeGuards
+{
+   char **paths;
+   int pathsAmount;
+   int pathsCapacity;
+} IncludeGuards;
+
+/* define a place in the lines of an included file where it includes another file */
+typedef struct IncludeReference
+{
+   int position;              /* the amount of lines that come before the other file */
+   struct IncludedFile *file; /* the other file */
+} IncludeReference;
+
+/* define a file included by .include - parsed once into its lines and macros, and shared by every file that
+   includes it (in every worker) until the end of the run */
+typedef struct IncludedFile
+{
+   char *path;                    /* the path, as written in the directive */
+   SourceFile *source;            /* the mapped file (the lines and the macros point into it) */
+   LineBuffer *lines;             /* the pre-assembled lines (without the files it includes) */
+   MacroTable *macros;            /* its macros (and the macros of the files it includes) */
+   IncludeReference *references;  /* the files it includes, by their place in the lines */
+   int referencesAmount;
+   int referencesCapacity;
+   int state;                     /* INCLUDE_PARSING or INCLUDE_READY */
+   int isError;                   /* flag if an error was found while parsing it */
+   char *messages;                /* the messages printed while parsing it (printed again by every file that includes it) */
+   size_t messagesSize;
+   struct IncludedFile *next;
+} IncludedFile;
+
+/* function that creates an empty macro table in an arena (returns NULL on a memory error) */
+MacroTable *initializeMacroTable(Arena *);
+
+/* function that returns a macro by its name and the name length (NULL if it doesn't exist) */
+Macro *getMacro(MacroTable *, char *, int);
+
+/* function that marks a body word that isn't a macro, so defining it later computes the expansions again
+   (takes the macro table, the word and its length) */
+void addMissedName(MacroTable *, char *, int);
 
 /* function to add a macro in the table
-   (takes the head of the list, name and definition) */
-int addMacro(MacroNode **, char *, char *);
+   (takes the table, name and the template of the body) */
+int addMacro(MacroTable *, char *, MacroTemplate *);
+
+/* function that splits a list of words separated by commas
+   (takes the list, the words and their lengths to fill and a line number. returns the amount of words or SYNTAX_ERROR) */
+int getMacroList(char *, char **, int *, int);
+
+/* function that gets the parameters of a macro definition
+   (takes the text after the macro name, the names and their lengths to fill and a line number. returns the amount or SYNTAX_ERROR) */
+int getMacroParameters(char *, char **, int *, int);
+
+/* function that parses a body line into the pieces of a macro template
+   (takes the arena, the template, the line and the names of the parameters with their lengths) */
+void addMacroLine(Arena *, MacroTemplate *, LineView *, char **, int *);
+
+/* function that expands a macro call into the output lines
+   (takes the macro table, the output, the macro, the text of the arguments and a line number. returns NO_ERROR or SYNTAX_ERROR) */
+int expandMacro(MacroTable *, LineBuffer *, Macro *, char *, int);
 
 /* function that checks if a macro starts (takes a line) */
 int isMacroStart(char *);
@@ -19,21 +117,40 @@ int isMacroEnd(char *);
 /* define a function that checks if a string is a valid macro name (takes the string and a line number) */
 int isValidMacroName(char *, int);
 
-/* define a function that handles memory error */
-void customHandleMemoryError(FILE *, MacroNode **);
+/* function that pre-assembles the lines of a source file
+   (takes the source, the output, the macro table, the include guards and the included file that is parsed - NULL for an
+   assembly file. returns TRUE if an error was found) */
+int preAssembleLines(SourceFile *, LineBuffer *, MacroTable *, IncludeGuards *, IncludedFile *);
+
+/* function that handles an include directive
+   (takes the text after the directive, the output, the macro table, the include guards, the included file that is parsed
+   and a line number. returns NO_ERROR or SYNTAX_ERROR) */
+int handleInclude(char *, LineBuffer *, MacroTable *, IncludeGuards *, IncludedFile *, int);
 
-/* define a function that frees the allocated memory for the macro list */
-void freeMacroList(MacroNode **);
+/* function that adds the lines and the macros of an included file (and of the files it includes) to a file
+   (takes the included file, the output - NULL to add only the macros, the macro table and the include guards) */
+void addIncludedFile(IncludedFile *, LineBuffer *, MacroTable *, IncludeGuards *);
 
-/* define the length of a register (with null terminator) */
-#define REGISTER_LENGTH 3
+/* function that checks if a path is in the include guards */
+int isIncluded(IncludeGuards *, char *);
 
-/* macro to see if a string is a directive name */
-#define IS_DIRECTIVE(str) (strcmp(str, "data") == 0 || strcmp(str, "string") == 0 || strcmp(str, "entry") == 0 || strcmp(str, "extern") == 0)
+/* function that adds a path to the include guards (takes the arena of the guards) */
+void addIncludeGuard(Arena *, IncludeGuards *, char *);
+
+/* function that returns an included file by its path, parsing it on the first time (NULL if it couldn't be opened) */
+IncludedFile *getIncludedFile(char *);
 
 /* max line length (including \n or \0) */
 #define MAX_LINE_LENGTH 81
 
+/* define the include directive (e.g. .include "prelude.as") */
+#define INCLUDE_DIRECTIVE ".include"
+#define INCLUDE_DIRECTIVE_LENGTH 8
+
+/* define the states of an included file */
+#define INCLUDE_PARSING 0
+#define INCLUDE_READY 1
+
 /* define macro start and end */
 #define MACRO_START "mcro"
 #define MACRO_END "mcroend"
@@ -42,12 +159,6 @@ void freeMacroList(MacroNode **);
 #define MACRO_START_LENGTH 4
 #define MACRO_END_LENGTH 7
 
-/* define the inital macro definition size */
-#define INITIAL_DEF_SIZE 0
-
-/* define the white spaces in 1 word */
-#define WHITE_SPACES " \t\n"
-
 /* define error messages */
 #define EXTRA_MACRO_START_CHARS_ERROR "Extra characters in macro assignment line; try removing those"
 #define EXTRA_MACRO_END_CHARS_ERROR "Extra characters in macro end line; try removing those"
@@ -61,21 +172,46 @@ void freeMacroList(MacroNode **);
 #define MACRO_CONTAINS_INVALID_CHAR "Found macro name: %s; a macro name can only contain letters, digits and underscore. try a different name"
 #define MACRO_NAME_IS_LABEL_ERROR "Found macro name '%.*s' that is also a label. Ensure to use a different name"
 
+#define MACRO_LIST_SYNTAX_ERROR "Invalid macro parameters or arguments; separate single words with a comma"
+#define MACRO_TOO_MANY_PARAMETERS_ERROR "Too many macro parameters or arguments; a macro can have at most %d parameters"
+#define MACRO_PARAMETER_TOO_BIG_ERROR "The macro parameter you provided is too big. ensure using a name with %d characters or less"
+#define MACRO_INVALID_PARAMETER_ERROR "Found macro parameter: %.*s; a parameter must start with a letter and contain only letters, digits and underscore"
+#define MACRO_PARAMETER_IS_KEYWORD_ERROR "Found macro parameter: %.*s; a parameter cannot be an instruction, register or directive name"
+#define MACRO_DUPLICATE_PARAMETER_ERROR "Found macro parameter: %.*s more than once; give every parameter a different name"
+#define MACRO_ARGUMENTS_AMOUNT_ERROR "Macro '%s' takes %d arguments but %d were given"
+#define MACRO_CALLS_ITSELF_ERROR "Macro '%s' calls itself through the macros in its body; remove the recursive call"
+#define MACRO_EXPANSION_TOO_BIG_ERROR "A line of the expansion of macro '%s' is too long; the maximum line length is %d characters"
+
+#define INCLUDE_PATH_ERROR "Invalid include directive; wrap the path of the included file between \"s"
+#define INCLUDE_OPEN_ERROR "Couldn't open the included file '%s'"
+#define INCLUDED_FILE_ERROR "Found errors in the included file '%s'"
+#define INCLUDED_FILE_MESSAGE "In the included file '%s':\n"
+
+/* define the maximum amount of parameters of a macro */
+#define MAX_MACRO_PARAMETERS 8
+
+/* define the parameter index of a literal piece */
+#define LITERAL_PIECE -1
+
+/* define the states of reading the arguments of a call in a macro body */
+#define BEFORE_ARGUMENT 0
+#define IN_ARGUMENT 1
+#define AFTER_ARGUMENT 2
+
+/* define the states of a macro expansion */
+#define EXPANSION_NOT_READY 0
+#define EXPANSION_IN_PROGRESS 1
+#define EXPANSION_READY 2
+
 /* define an error code */
 #define EXTRANOUS_CHARACTERS -1
 #define NON_MACRO_RELATED -2
 
-/* define a macro that checks if a word is an instruction */
-#define IS_INSTRUCTION(word) (strcmp(word, "mov") == 0 || strcmp(word, "cmp") == 0 || strcmp(word, "add") == 0 || strcmp(word, "sub") == 0 || strcmp(word, "not") == 0 || strcmp(word, "clr") == 0 || strcmp(word, "lea") == 0 || strcmp(word, "inc") == 0 || strcmp(word, "dec") == 0 || strcmp(word, "jmp") == 0 || strcmp(word, "bne") == 0 || strcmp(word, "red") == 0 || strcmp(word, "prn") == 0 || strcmp(word, "jsr") == 0 || strcmp(word, "rts") == 0 || strcmp(word, "stop") == 0)
+/* define a macro that checks if a line starts with an include directive */
+#define STARTS_WITH_INCLUDE(line) ((strncmp(line, INCLUDE_DIRECTIVE, INCLUDE_DIRECTIVE_LENGTH) == 0) && IS_WORD_END(*(line + INCLUDE_DIRECTIVE_LENGTH)))
 
 /* define macros that check if a line starts with macro start */
-#define STARTS_WITH_MACRO_START(line) ((strncmp(line, MACRO_START, MACRO_START_LENGTH) == 0) && (isspace(*(line + MACRO_START_LENGTH)) || *(line + MACRO_START_LENGTH) == NULL_TERMINATOR))
+#define STARTS_WITH_MACRO_START(line) ((strncmp(line, MACRO_START, MACRO_START_LENGTH) == 0) && IS_WORD_END(*(line + MACRO_START_LENGTH)))
 
 /* define macros that check if a line starts with macro end */
-#define STARTS_WITH_MACRO_END(line) ((strncmp(line, MACRO_END, MACRO_END_LENGTH) == 0) && (isspace(*(line + MACRO_END_LENGTH)) || *(line + MACRO_END_LENGTH) == NULL_TERMINATOR))
-
-/* define the underscore char */
-#define UNDERSCORE '_'
-
-/* define the comment character */
-#define COMMENT_CHAR ';'
\ No newline at end of file
+#define STARTS_WITH_MACRO_END(line) ((strncmp(line, MACRO_END, MACRO_END_LENGTH) == 0) && IS_WORD_END(*(line + MACRO_END_LENGTH)))
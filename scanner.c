@@ -0,0 +1,280 @@
+#include "header.h"
+
+#ifdef SCANNER_HAS_SIMD
+#include <immintrin.h>
+#endif
+
+/* the scanner: finds the structural characters of a line (white spaces, null-terminators, commas, quote marks and
+   colons) a block at a time, and keeps their positions as bit masks. the lexer then jumps between them with bit
+   operations instead of checking the characters one by one. a line is scanned on its own (the lines are padded
+   to SCAN_BUFFER_SIZE characters, so a line is a few blocks) */
+
+/* the scanner that is used (chosen once by initializeScanner) */
+static void (*lineScanner)(char *, LineMasks *) = scanLineScalar;
+
+/* function that returns the position of the lowest set bit (the bits can't be 0) */
+static int lowestBit(unsigned int bits)
+{
+#ifdef __GNUC__
+    return __builtin_ctz(bits);
+#else
+    int position = 0;
+
+    while (!(bits & 1))
+    {
+        bits >>= 1;
+        position++;
+    }
+
+    return position;
+#endif
+}
+
+/* function that sets the length of a line from the mask of its null-terminators */
+static void setScannedLength(LineMasks *masks, unsigned int *nulls)
+{
+    masks->length = findNextBit(nulls, 0);
+}
+
+/* function that sets the masks of the quote marks and the colons - a colon inside a string isn't structural.
+   the characters inside the strings are found with a prefix xor of the quote marks (a bit is set from an opening
+   quote mark up to its closing one), carried from word to word */
+static void setQuotedMasks(LineMasks *masks, unsigned int *quotes, unsigned int *colons)
+{
+    unsigned int carry = 0; /* all ones if the previous word ended inside a string */
+    int word;
+
+    for (word = 0; word < SCAN_MASK_WORDS; word++)
+    {
+        unsigned int inside = quotes[word];
+
+        inside ^= inside << 1;
+        inside ^= inside << 2;
+        inside ^= inside << 4;
+        inside ^= inside << 8;
+        inside ^= inside << 16;
+        inside ^= carry;
+
+        masks->quotes[word] = quotes[word];
+        masks->colons[word] = colons[word] & ~inside;
+        carry = (inside >> (SCAN_BLOCK_SIZE - 1)) ? ~0u : 0;
+    }
+}
+
+/* function that chooses the fastest scanner the processor supports */
+void initializeScanner()
+{
+#ifdef SCANNER_HAS_SIMD
+    __builtin_cpu_init();
+
+    if (__builtin_cpu_supports("avx2"))
+    {
+        lineScanner = scanLineAvx2;
+    }
+    else if (__builtin_cpu_supports("sse2"))
+    {
+        lineScanner = scanLineSse2;
+    }
+#endif
+}
+
+/* function that scans a line buffer of SCAN_BUFFER_SIZE characters into its masks */
+void scanLine(char *line, LineMasks *masks)
+{
+    lineScanner(line, masks);
+}
+
+/* function that scans a line a character at a time */
+void scanLineScalar(char *line, LineMasks *masks)
+{
+    unsigned int nulls[SCAN_MASK_WORDS];
+    unsigned int quotes[SCAN_MASK_WORDS];
+    unsigned int colons[SCAN_MASK_WORDS];
+    int word;
+    int i;
+
+    for (word = 0; word < SCAN_MASK_WORDS; word++)
+    {
+        unsigned int spaces = 0;
+        unsigned int ends = 0;
+        unsigned int commas = 0;
+
+        quotes[word] = 0;
+        colons[word] = 0;
+
+        for (i = 0; i < SCAN_BLOCK_SIZE; i++)
+        {
+            char current = line[word * SCAN_BLOCK_SIZE + i];
+            unsigned int bit = 1u << i;
+
+            if (IS_SPACE(current))
+            {
+                spaces |= bit;
+            }
+            else if (CHARACTER_CLASS(current) & CHAR_END)
+            {
+                ends |= bit;
+            }
+            else if (IS_COMMA(current))
+            {
+                commas |= bit;
+            }
+            else if (IS_QUOTE(current))
+            {
+                quotes[word] |= bit;
+            }
+            else if (IS_COLON(current))
+            {
+                colons[word] |= bit;
+            }
+        }
+
+        masks->spaces[word] = spaces;
+        masks->wordEnds[word] = spaces | ends;
+        masks->operandEnds[word] = spaces | ends | commas;
+        nulls[word] = ends;
+    }
+
+    setQuotedMasks(masks, quotes, colons);
+    setScannedLength(masks, nulls);
+}
+
+#ifdef SCANNER_HAS_SIMD
+
+/* function that scans a line 16 characters at a time (2 blocks of 16 make a mask word) */
+__attribute__((target("sse2"))) void scanLineSse2(char *line, LineMasks *masks)
+{
+    unsigned int nulls[SCAN_MASK_WORDS];
+    unsigned int quotes[SCAN_MASK_WORDS];
+    unsigned int colons[SCAN_MASK_WORDS];
+    __m128i space = _mm_set1_epi8(' ');
+    __m128i belowTab = _mm_set1_epi8('\t' - 1); /* the white spaces are ' ' and '\t' to '\r' */
+    __m128i aboveReturn = _mm_set1_epi8('\r' + 1);
+    __m128i zero = _mm_setzero_si128();
+    __m128i comma = _mm_set1_epi8(COMMA);
+    __m128i quote = _mm_set1_epi8(QUOTE_MARK);
+    __m128i colon = _mm_set1_epi8(COLON);
+    int word;
+    int half;
+
+    for (word = 0; word < SCAN_MASK_WORDS; word++)
+    {
+        unsigned int spaces = 0;
+        unsigned int ends = 0;
+        unsigned int commas = 0;
+
+        quotes[word] = 0;
+        colons[word] = 0;
+
+        for (half = 0; half < 2; half++)
+        {
+            __m128i block = _mm_loadu_si128((__m128i *)(line + word * SCAN_BLOCK_SIZE + half * 16));
+            __m128i isSpace = _mm_or_si128(_mm_cmpeq_epi8(block, space),
+                                           _mm_and_si128(_mm_cmpgt_epi8(block, belowTab), _mm_cmpgt_epi8(aboveReturn, block)));
+            int shift = half * 16;
+
+            spaces |= (unsigned int)_mm_movemask_epi8(isSpace) << shift;
+            ends |= (unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(block, zero)) << shift;
+            commas |= (unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(block, comma)) << shift;
+            quotes[word] |= (unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(block, quote)) << shift;
+            colons[word] |= (unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(block, colon)) << shift;
+        }
+
+        masks->spaces[word] = spaces;
+        masks->wordEnds[word] = spaces | ends;
+        masks->operandEnds[word] = spaces | ends | commas;
+        nulls[word] = ends;
+    }
+
+    setQuotedMasks(masks, quotes, colons);
+    setScannedLength(masks, nulls);
+}
+
+/* function that scans a line 32 characters at a time (a block makes a mask word) */
+__attribute__((target("avx2"))) void scanLineAvx2(char *line, LineMasks *masks)
+{
+    unsigned int nulls[SCAN_MASK_WORDS];
+    unsigned int quotes[SCAN_MASK_WORDS];
+    unsigned int colons[SCAN_MASK_WORDS];
+    __m256i space = _mm256_set1_epi8(' ');
+    __m256i belowTab = _mm256_set1_epi8('\t' - 1); /* the white spaces are ' ' and '\t' to '\r' */
+    __m256i aboveReturn = _mm256_set1_epi8('\r' + 1);
+    __m256i zero = _mm256_setzero_si256();
+    __m256i comma = _mm256_set1_epi8(COMMA);
+    __m256i quote = _mm256_set1_epi8(QUOTE_MARK);
+    __m256i colon = _mm256_set1_epi8(COLON);
+    int word;
+
+    for (word = 0; word < SCAN_MASK_WORDS; word++)
+    {
+        __m256i block = _mm256_loadu_si256((__m256i *)(line + word * SCAN_BLOCK_SIZE));
+        __m256i isSpace = _mm256_or_si256(_mm256_cmpeq_epi8(block, space),
+                                          _mm256_and_si256(_mm256_cmpgt_epi8(block, belowTab), _mm256_cmpgt_epi8(aboveReturn, block)));
+        unsigned int spaces = (unsigned int)_mm256_movemask_epi8(isSpace);
+        unsigned int ends = (unsigned int)_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, zero));
+
+        masks->spaces[word] = spaces;
+        masks->wordEnds[word] = spaces | ends;
+        masks->operandEnds[word] = spaces | ends | (unsigned int)_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, comma));
+        quotes[word] = (unsigned int)_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, quote));
+        colons[word] = (unsigned int)_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, colon));
+        nulls[word] = ends;
+    }
+
+    setQuotedMasks(masks, quotes, colons);
+    setScannedLength(masks, nulls);
+}
+
+#endif
+
+/* function that returns the position of the first set bit of a mask from a position (SCAN_BUFFER_SIZE if none) */
+int findNextBit(unsigned int *mask, int position)
+{
+    int word = position / SCAN_BLOCK_SIZE;
+    unsigned int bits;
+
+    if (position >= SCAN_BUFFER_SIZE)
+    {
+        return SCAN_BUFFER_SIZE;
+    }
+
+    /* ignore the bits before the position */
+    bits = mask[word] & (~0u << (position % SCAN_BLOCK_SIZE));
+
+    while (bits == 0)
+    {
+        if (++word == SCAN_MASK_WORDS)
+        {
+            return SCAN_BUFFER_SIZE;
+        }
+        bits = mask[word];
+    }
+
+    return word * SCAN_BLOCK_SIZE + lowestBit(bits);
+}
+
+/* function that returns the position of the first clear bit of a mask from a position (SCAN_BUFFER_SIZE if none) */
+int findNextClearBit(unsigned int *mask, int position)
+{
+    int word = position / SCAN_BLOCK_SIZE;
+    unsigned int bits;
+
+    if (position >= SCAN_BUFFER_SIZE)
+    {
+        return SCAN_BUFFER_SIZE;
+    }
+
+    /* ignore the bits before the position */
+    bits = ~mask[word] & (~0u << (position % SCAN_BLOCK_SIZE));
+
+    while (bits == 0)
+    {
+        if (++word == SCAN_MASK_WORDS)
+        {
+            return SCAN_BUFFER_SIZE;
+        }
+        bits = ~mask[word];
+    }
+
+    return word * SCAN_BLOCK_SIZE + lowestBit(bits);
+}
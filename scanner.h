@@ -0,0 +1,51 @@
+/* define the size of a scanned line buffer - room for a line of MAX_LINE_LENGTH characters and its null-terminator,
+   rounded up to blocks of SCAN_BLOCK_SIZE characters (the buffer is padded with null-terminators) */
+#define SCAN_BUFFER_SIZE 96
+
+/* define the amount of characters scanned at once (a mask word holds a bit for each of them) */
+#define SCAN_BLOCK_SIZE 32
+
+/* define the amount of mask words of a line */
+#define SCAN_MASK_WORDS (SCAN_BUFFER_SIZE / SCAN_BLOCK_SIZE)
+
+/* define the position masks of a scanned line (bit i of a mask is set if the character i is in the class) */
+typedef struct LineMasks
+{
+   unsigned int spaces[SCAN_MASK_WORDS];      /* the white spaces */
+   unsigned int wordEnds[SCAN_MASK_WORDS];    /* the white spaces and the null-terminators */
+   unsigned int operandEnds[SCAN_MASK_WORDS]; /* the white spaces, the null-terminators and the commas */
+   unsigned int quotes[SCAN_MASK_WORDS];      /* the quote marks */
+   unsigned int colons[SCAN_MASK_WORDS];      /* the colons that are not inside a string (between quote marks) */
+   int length;                                /* the position of the first null-terminator */
+} LineMasks;
+
+/* define the vector instructions the scanner can use (it checks the processor at runtime) */
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SCANNER_HAS_SIMD
+#endif
+
+/* declare a function that chooses the fastest scanner the processor supports (called once, before any line is scanned) */
+void initializeScanner();
+
+/* declare a function that scans a line buffer of SCAN_BUFFER_SIZE characters into its masks */
+void scanLine(char *, LineMasks *);
+
+/* declare the scanner that checks a character at a time (used when there are no vector instructions) */
+void scanLineScalar(char *, LineMasks *);
+
+#ifdef SCANNER_HAS_SIMD
+/* declare the scanner that uses SSE2 (16 characters at a time) */
+void scanLineSse2(char *, LineMasks *);
+
+/* declare the scanner that uses AVX2 (32 characters at a time) */
+void scanLineAvx2(char *, LineMasks *);
+#endif
+
+/* declare a function that returns the position of the first set bit of a mask from a position (SCAN_BUFFER_SIZE if none) */
+int findNextBit(unsigned int *, int);
+
+/* declare a function that returns the position of the first clear bit of a mask from a position (SCAN_BUFFER_SIZE if none) */
+int findNextClearBit(unsigned int *, int);
+
+/* define a macro that checks if the bit of a position is set in a mask */
+#define IS_BIT_SET(mask, position) (((mask)[(position) / SCAN_BLOCK_SIZE] >> ((position) % SCAN_BLOCK_SIZE)) & 1)
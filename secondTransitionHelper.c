@@ -3,70 +3,8 @@
 
 /* assisting functions for the second transition: */
 
-/* function that skips the label in line */
-void skipLabel(char **line)
-{
-    char *colon = (char *)strchr(*line, COLON); /* find the colon position */
-    if (colon != NULL)
-    {
-        /* if a colon was found, skip after it */
-        *line = colon + 1;
-
-        skipWhiteSpaces(line); /* skip white spaces as well */
-    }
-}
-
-/* function that skips an operand */
-void skipOperand(char **line)
-{
-    while (!isspace(**line) && **line != COMMA)
-    {
-        (*line)++;
-    }
-
-    skipWhiteSpaces(line); /* skip the whitespaces */
-
-    if (**line == COMMA)
-    {
-        (*line)++; /* skip the commma if exists */
-    }
-
-    skipWhiteSpaces(line); /* skip remaining whitespaces */
-}
-
-/* function that adds the entry flag to an entry symbol */
-int addEntryFlag(SymbolNode *head, char *symbolName, int lineNum)
-{
-    SymbolNode *current = head;
-
-    /* loop through the nodes and check for this symbolname */
-    while (current != NULL)
-    {
-        if (strcmp(current->symbol, symbolName) == 0)
-        {
-            /* found symbol */
-
-            /* ensure its not type external */
-            if (strcmp(current->type, TYPE_EXTERNAL) == 0)
-            {
-                printErrorInLine(EXTERNAL_AND_ENTRY_ERROR, lineNum, symbolName);
-                return SYNTAX_ERROR;
-            }
-
-            current->isEntry = TRUE;
-            return NO_ERROR;
-        }
-
-        current = current->next;
-    }
-
-    /* no symbol was found - print the error message */
-    printErrorInLine(LABEL_DOESNT_EXIST_ERROR, lineNum, symbolName);
-    return SYNTAX_ERROR;
-}
-
 /* function that fills the code left to be coden from the first transition (specific for relative addressing) */
-void fillRelativeAddressingCode(MemoryNode *instructionNode, SymbolNode *symbol, int originalValue)
+void fillRelativeAddressingCode(int *word, Symbol *symbol, int originalValue)
 {
     int code;
 
@@ -77,11 +15,11 @@ void fillRelativeAddressingCode(MemoryNode *instructionNode, SymbolNode *symbol,
     code = valueDifference << (A_POS + 1); /* the 3-23 bits */
     code |= 1 << A_POS;
 
-    instructionNode->code = code; /* update the code */
+    *word = code; /* update the code */
 }
 
 /* function that fills the code left to be coden from the first transition (specific for direct addressing) */
-void fillDirectAddressingCode(MemoryNode *instructionNode, SymbolNode *symbol)
+void fillDirectAddressingCode(int *word, Symbol *symbol)
 {
     int code;
 
@@ -98,69 +36,39 @@ void fillDirectAddressingCode(MemoryNode *instructionNode, SymbolNode *symbol)
         code |= (1 << R_POS); /* R on, E and A off */
     }
 
-    instructionNode->code = code; /* update the code */
+    *word = code; /* update the code */
 }
 
-/* function that gets the operand symbol node */
-SymbolNode *getOperandSymbol(char **line, SymbolNode *head, int lineNum)
+/* function that adds the address of a relocatable word (R flag) to the relocation table.
+   the words are coded in the order of their addresses, so the table stays sorted */
+int addRelocation(AssemblerContext *context, int address)
 {
-    char *start;    /* initialize the start of the symbol */
-    int length = 0; /* initialize the length */
-
-    SymbolNode *current;
-
-    start = *line; /* get the start of the symbol name */
-
-    while (**line != NULL_TERMINATOR && !isspace(**line) && **line != COMMA)
-    {
-        (*line)++; /* move to the next character */
-        length++;  /* increment length */
-    }
-
-    current = head;
+    int *relocations = growArray(context->arena, context->relocations, context->relocationsAmount, &context->relocationsCapacity, sizeof(int));
 
-    while (current)
+    if (relocations == NULL)
     {
-        if (strncmp(current->symbol, start, length) == 0)
-        {
-            /* found a symbol */
-
-            /* skip already to the next word (error messages should be handled in the first transition) */
-
-            skipWhiteSpaces(line);
-
-            while (**line == COMMA)
-            {
-                (*line)++;
-                skipWhiteSpaces(line);
-            }
-
-            skipWhiteSpaces(line);
-
-            return current;
-        }
-        current = current->next;
+        return MEMORY_ERROR; /* memory allocation failed */
     }
+    context->relocations = relocations;
 
-    /* the symbol is not defined, print an error */
-    printErrorInLine(SYMBOL_DOESNT_EXIST_ERROR, lineNum, length, start);
+    context->relocations[context->relocationsAmount++] = address;
 
-    return NULL; /* indicate that the symbol doesnt exist */
+    return NO_ERROR;
 }
 
 /* function that adds a symbol to the external symbol list */
-int addToExternalList(ExternalWordNode **head, char *symbol, int address)
+int addToExternalList(Arena *arena, ExternalWordNode **head, char *symbol, int address)
 {
     /* allocate memory for the symbol */
-    ExternalWordNode *newNode = (ExternalWordNode *)malloc(sizeof(ExternalWordNode));
+    ExternalWordNode *newNode = (ExternalWordNode *)arenaAllocate(arena, sizeof(ExternalWordNode));
 
     if (!newNode)
     {
         return MEMORY_ERROR; /* memory allocation failed */
     }
 
-    /* copy the values */
-    strcpy(newNode->symbol, symbol);
+    /* copy the values (the name is interned in the symbol table, so it isn't copied) */
+    newNode->symbol = symbol;
     newNode->value = address;
 
     newNode->next = *head;
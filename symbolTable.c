@@ -0,0 +1,182 @@
+#include "header.h"
+#include "assemble.h"
+
+/* the symbol table: an open addressing hash table (linear probing) that indexes an array of the
+   symbols in insertion order. each name is interned once into the arena of the table */
+
+/* function that creates an empty symbol table in an arena (returns NULL on a memory error) */
+SymbolTable *initializeSymbolTable(Arena *arena)
+{
+    SymbolTable *table = (SymbolTable *)arenaAllocate(arena, sizeof(SymbolTable));
+    if (table == NULL)
+    {
+        return NULL;
+    }
+
+    table->symbols = NULL;
+    table->symbolsAmount = 0;
+    table->symbolsCapacity = 0;
+    table->arena = arena;
+
+    /* all the slots start empty */
+    table->slotsCapacity = INITIAL_SLOTS_CAPACITY;
+    if ((table->slots = allocateSlots(arena, table->slotsCapacity)) == NULL)
+    {
+        return NULL;
+    }
+
+    return table;
+}
+
+/* function that returns the slot of a name: the slot that holds it, or the empty slot it would be placed in */
+static int findSlot(SymbolTable *table, char *name, int length, unsigned long hash)
+{
+    int mask = table->slotsCapacity - 1;
+    int slot = (int)(hash & mask);
+
+    while (table->slots[slot] != EMPTY_SLOT)
+    {
+        Symbol *symbol = &table->symbols[table->slots[slot] - 1];
+
+        if (symbol->hash == hash && symbol->length == length && memcmp(symbol->symbol, name, length) == 0)
+        {
+            break; /* found the name */
+        }
+
+        slot = (slot + 1) & mask; /* try the next slot */
+    }
+
+    return slot;
+}
+
+/* function that doubles the amount of slots and places every symbol again (returns FALSE on a memory error) */
+static int growSlots(SymbolTable *table)
+{
+    int *slots = allocateSlots(table->arena, table->slotsCapacity * 2);
+    int i;
+
+    if (slots == NULL)
+    {
+        return FALSE;
+    }
+
+    /* the old slots are released with the rest of the arena */
+    table->slots = slots;
+    table->slotsCapacity *= 2;
+
+    for (i = 0; i < table->symbolsAmount; i++)
+    {
+        Symbol *symbol = &table->symbols[i];
+        table->slots[findSlot(table, symbol->symbol, symbol->length, symbol->hash)] = i + 1;
+    }
+
+    return TRUE;
+}
+
+/* function that returns a symbol by its name and the name length (NULL if it doesn't exist) */
+Symbol *getSymbol(SymbolTable *table, char *name, int length)
+{
+    int slot;
+
+    /* a longer name can't be a symbol */
+    if (length > MAX_SYMBOL_LENGTH)
+    {
+        return NULL;
+    }
+
+    slot = findSlot(table, name, length, hashName(name, length));
+
+    return table->slots[slot] == EMPTY_SLOT ? NULL : &table->symbols[table->slots[slot] - 1];
+}
+
+/* function that checks if a symbol with a given length was already defined */
+int isSymbolDefined(SymbolTable *table, char *symbol, int length)
+{
+    return getSymbol(table, symbol, length) != NULL;
+}
+
+/* function that adds a symbol with a given length to the symbol table */
+int addToSymbolTable(SymbolTable *table, char *symbol, int length, int value, char *type)
+{
+    Symbol *newSymbol;
+    Symbol *symbols;
+
+    if (length > MAX_SYMBOL_LENGTH)
+    {
+        length = MAX_SYMBOL_LENGTH;
+    }
+
+    /* keep at most half of the slots used */
+    if ((table->symbolsAmount + 1) * 2 > table->slotsCapacity && !growSlots(table))
+    {
+        return MEMORY_ERROR; /* memory allocation failed */
+    }
+
+    if ((symbols = growArray(table->arena, table->symbols, table->symbolsAmount, &table->symbolsCapacity, sizeof(Symbol))) == NULL)
+    {
+        return MEMORY_ERROR; /* memory allocation failed */
+    }
+    table->symbols = symbols;
+
+    newSymbol = &table->symbols[table->symbolsAmount];
+
+    /* intern the name (+1 for the null-terminator, the name is a view into the line) */
+    if ((newSymbol->symbol = arenaAllocate(table->arena, length + 1)) == NULL)
+    {
+        return MEMORY_ERROR; /* memory allocation failed */
+    }
+    memcpy(newSymbol->symbol, symbol, length);
+    newSymbol->symbol[length] = NULL_TERMINATOR;
+
+    newSymbol->length = length;
+    newSymbol->hash = hashName(newSymbol->symbol, length);
+    newSymbol->value = value;
+
+    strncpy(newSymbol->type, type, MAX_TYPE_LENGTH);
+    newSymbol->type[MAX_TYPE_LENGTH] = NULL_TERMINATOR;
+
+    newSymbol->isEntry = FALSE; /* will be updated in the second transition if neccessary */
+
+    table->symbolsAmount++;
+    table->slots[findSlot(table, newSymbol->symbol, length, newSymbol->hash)] = table->symbolsAmount;
+
+    return NO_ERROR;
+}
+
+/* function that adds the entry flag to an entry symbol */
+int addEntryFlag(SymbolTable *table, char *symbolName, int lineNum)
+{
+    Symbol *symbol = getSymbol(table, symbolName, strlen(symbolName));
+
+    if (symbol == NULL)
+    {
+        /* no symbol was found - print the error message */
+        printErrorInLine(LABEL_DOESNT_EXIST_ERROR, lineNum, symbolName);
+        return SYNTAX_ERROR;
+    }
+
+    /* ensure its not type external */
+    if (strcmp(symbol->type, TYPE_EXTERNAL) == 0)
+    {
+        printErrorInLine(EXTERNAL_AND_ENTRY_ERROR, lineNum, symbolName);
+        return SYNTAX_ERROR;
+    }
+
+    symbol->isEntry = TRUE;
+    return NO_ERROR;
+}
+
+/* function that adds the ICF to the value of each symbol that contains data, to correcten their address */
+void updateDataSymbols(SymbolTable *table, int ICF)
+{
+    int i;
+
+    for (i = 0; i < table->symbolsAmount; i++)
+    {
+        /* check if the symbol is type data */
+        if (strcmp(table->symbols[i].type, TYPE_DATA) == 0)
+        {
+            table->symbols[i].value += ICF; /* add ICF to the value */
+        }
+    }
+}
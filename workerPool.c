@@ -0,0 +1,175 @@
+#include "header.h"
+#include "workerPool.h"
+#include <pthread.h>
+#include <unistd.h>
+
+/* define the state shared between the workers */
+typedef struct WorkerPool
+{
+    FileJob *jobs;
+    int jobsAmount;
+    AssemblerOptions *options;
+    int nextJob; /* the index of the next job to hand to a worker */
+    pthread_mutex_t lock;
+    pthread_cond_t jobDone;
+} WorkerPool;
+
+/* the routine of every worker: takes the next file and assembles it until no files are left */
+static void *workerRoutine(void *arg)
+{
+    WorkerPool *pool = (WorkerPool *)arg;
+    Arena *arena = initializeArena(); /* the arena of the worker (its pages are reused for every file) */
+
+    if (arena == NULL)
+    {
+        handleMemoryError();
+    }
+
+    while (TRUE)
+    {
+        FileJob *job;
+        FILE *messageStream;
+
+        /* take the next job */
+        pthread_mutex_lock(&pool->lock);
+        if (pool->nextJob >= pool->jobsAmount)
+        {
+            pthread_mutex_unlock(&pool->lock);
+            break; /* no jobs are left */
+        }
+        job = &pool->jobs[pool->nextJob++];
+        pthread_mutex_unlock(&pool->lock);
+
+        /* collect the messages of the file in memory (printed in order by the main thread) */
+        messageStream = open_memstream(&job->messages, &job->messagesSize);
+        if (messageStream == NULL)
+        {
+            handleMemoryError();
+        }
+
+        setMessageStream(messageStream);
+        job->foundError = assembleFile(job->filename, pool->options, arena);
+        setMessageStream(NULL);
+
+        fclose(messageStream); /* also sets the messages buffer */
+
+        /* mark the job as done and wake the main thread */
+        pthread_mutex_lock(&pool->lock);
+        job->isDone = TRUE;
+        pthread_cond_broadcast(&pool->jobDone);
+        pthread_mutex_unlock(&pool->lock);
+    }
+
+    freeArena(arena);
+
+    return NULL;
+}
+
+/* assembles the jobs on a pool of workers. the messages of each file are printed in the order of the jobs */
+int runWorkerPool(FileJob *jobs, int jobsAmount, int workersAmount, AssemblerOptions *options)
+{
+    WorkerPool pool;
+    pthread_t *workers;
+    int createdWorkers = 0;
+    int foundError = FALSE;
+    int i;
+
+    /* no need for more workers than files */
+    if (workersAmount > jobsAmount)
+    {
+        workersAmount = jobsAmount;
+    }
+
+    /* with a single worker simply assemble the files one after the other */
+    if (workersAmount <= 1)
+    {
+        Arena *arena = initializeArena(); /* the pages of the arena are reused for every file */
+
+        if (arena == NULL)
+        {
+            handleMemoryError();
+        }
+
+        for (i = 0; i < jobsAmount; i++)
+        {
+            if (assembleFile(jobs[i].filename, options, arena))
+            {
+                foundError = TRUE;
+            }
+        }
+
+        freeArena(arena);
+
+        return foundError;
+    }
+
+    pool.jobs = jobs;
+    pool.jobsAmount = jobsAmount;
+    pool.options = options;
+    pool.nextJob = 0;
+    pthread_mutex_init(&pool.lock, NULL);
+    pthread_cond_init(&pool.jobDone, NULL);
+
+    workers = malloc(workersAmount * sizeof(pthread_t));
+    if (!workers)
+    {
+        handleMemoryError();
+    }
+
+    /* start the workers */
+    for (i = 0; i < workersAmount; i++)
+    {
+        if (pthread_create(&workers[createdWorkers], NULL, workerRoutine, &pool) != 0)
+        {
+            printError(THREAD_CREATE_ERROR, createdWorkers);
+            break;
+        }
+        createdWorkers++;
+    }
+
+    /* if no worker could be created, assemble the files on this thread */
+    if (createdWorkers == 0)
+    {
+        workerRoutine(&pool);
+    }
+
+    /* print the messages of each file in order, as soon as its done */
+    for (i = 0; i < jobsAmount; i++)
+    {
+        pthread_mutex_lock(&pool.lock);
+        while (!jobs[i].isDone)
+        {
+            pthread_cond_wait(&pool.jobDone, &pool.lock);
+        }
+        pthread_mutex_unlock(&pool.lock);
+
+        fwrite(jobs[i].messages, 1, jobs[i].messagesSize, stdout);
+        free(jobs[i].messages);
+        jobs[i].messages = NULL;
+
+        if (jobs[i].foundError)
+        {
+            foundError = TRUE;
+        }
+    }
+
+    /* wait for the workers to finish */
+    for (i = 0; i < createdWorkers; i++)
+    {
+        pthread_join(workers[i], NULL);
+    }
+
+    free(workers);
+    pthread_cond_destroy(&pool.jobDone);
+    pthread_mutex_destroy(&pool.lock);
+
+    return foundError;
+}
+
+/* returns the default amount of workers (the amount of online cores) */
+int getDefaultWorkersAmount()
+{
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+
+    return cores > 0 ? (int)cores : 1;
+}
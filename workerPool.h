@@ -0,0 +1,24 @@
+/* define a job of the worker pool (a single file to assemble) */
+typedef struct FileJob
+{
+    char *filename;  /* the file name as inserted in the command line */
+    int foundError;  /* the error flag of the file (set by the worker) */
+    char *messages;  /* the messages printed while assembling the file */
+    size_t messagesSize;
+    int isDone;      /* flag if the worker finished the file */
+} FileJob;
+
+/* declare a function that assembles the jobs with a given amount of workers
+   (returns TRUE if an error was found in any of the files, FALSE otherwise) */
+int runWorkerPool(FileJob *, int, int, AssemblerOptions *);
+
+/* declare a function that returns the default amount of workers (the amount of cores) */
+int getDefaultWorkersAmount();
+
+/* define the option that sets the amount of workers */
+#define JOBS_OPTION "-j"
+#define JOBS_OPTION_LENGTH 2
+
+/* define error messages */
+#define INVALID_JOBS_AMOUNT_ERROR "Invalid amount of workers '%s'. Ensure to insert a positive number after -j"
+#define THREAD_CREATE_ERROR "Couldn't create a worker thread, continuing with %d workers"
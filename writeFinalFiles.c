@@ -1,10 +1,22 @@
 #include "header.h"
 #include "assemble.h"
+#include "binaryObject.h"
+#include "workerPool.h"
+#include <pthread.h>
 
-/* creates / wrights to the object file (if needed) */
-void writeObjectFile(int icf, int dcf, char *filename, MemoryNode *instructionHead, MemoryNode *dataHead)
+/* creates / wrights to the object file (if needed). every record has the same length, so the size of the file
+   is known up front: a new file is sized and mapped, and its records are formatted in place. when the existing file
+   has the same size, the records are formatted into memory first and the file is replaced only if they changed */
+void writeObjectFile(int icf, int dcf, char *filename, MemoryImage *instructionImage, MemoryImage *dataImage)
 {
-    FILE *objectFile;
+    char header[2 * MAX_NUMBER_DIGITS + 3]; /* initialize the 'title' of the file (2 numbers, a space, \n and \0) */
+    OutputFile objectFile;                  /* initialize the object file */
+    int isError = FALSE;                    /* initialize the error flag */
+    int headerLength;
+    int recordsAmount;
+    int fileSize;
+    char *output;
+    int i;
 
     /* ensure the object file wouldn't be empty */
     if (icf == INITIAL_IC && dcf == INITIAL_DC)
@@ -12,37 +24,375 @@ void writeObjectFile(int icf, int dcf, char *filename, MemoryNode *instructionHe
         return;
     }
 
-    objectFile = openObjectFile(filename);
-    if (objectFile == NULL)
+    headerLength = sprintf(header, "%7d %d\n", icf - INITIAL_IC, dcf);
+
+    /* the code records come first, then the data records (with the regions expanded) */
+    recordsAmount = instructionImage->wordsAmount + dataImage->wordsAmount;
+    for (i = 0; i < dataImage->regionsAmount; i++)
+    {
+        recordsAmount += dataImage->regions[i].wordsAmount;
+    }
+    fileSize = headerLength + recordsAmount * OBJECT_RECORD_LENGTH;
+
+    openObjectFile(filename, &objectFile);
+
+    if (objectFile.existing != NULL && objectFile.existing->size == fileSize)
+    {
+        if ((output = malloc(fileSize)) == NULL)
+        {
+            handleMemoryError();
+        }
+
+        /* write the 'title' of the file, then the records */
+        memcpy(output, header, headerLength);
+        formatObjectRecords(output + headerLength, recordsAmount, icf, instructionImage, dataImage);
+
+        if (!isOutputUnchanged(&objectFile, output, fileSize))
+        {
+            isError = !writeOutputFile(&objectFile, output, fileSize);
+        }
+
+        free(output);
+    }
+    else if ((output = mapOutputFile(&objectFile, fileSize)) != NULL)
+    {
+        /* write the 'title' of the file, then the records */
+        memcpy(output, header, headerLength);
+        formatObjectRecords(output + headerLength, recordsAmount, icf, instructionImage, dataImage);
+
+        unmapOutputFile(output, fileSize);
+    }
+    else
+    {
+        /* the error of creating the file was already printed */
+        if (objectFile.fd != -1)
+        {
+            printError(OBJECT_FILE_WRITE_ERROR, filename);
+        }
+        isError = TRUE;
+    }
+
+    closeOutputFile(&objectFile, isError); /* close the file */
+}
+
+/* formats the records of the object file - in chunks, by several threads when there are many of them */
+void formatObjectRecords(char *output, int recordsAmount, int icf, MemoryImage *instructionImage, MemoryImage *dataImage)
+{
+    ObjectChunk chunks[MAX_FORMATTING_THREADS];
+    pthread_t threads[MAX_FORMATTING_THREADS];
+    int isThreadCreated[MAX_FORMATTING_THREADS];
+    int chunksAmount;
+    int i;
+
+    /* split the records into chunks (a chunk isn't worth a thread unless its large) */
+    chunksAmount = recordsAmount / MIN_RECORDS_IN_CHUNK;
+    if (chunksAmount > getDefaultWorkersAmount())
+    {
+        chunksAmount = getDefaultWorkersAmount();
+    }
+    if (chunksAmount > MAX_FORMATTING_THREADS)
+    {
+        chunksAmount = MAX_FORMATTING_THREADS;
+    }
+    if (chunksAmount < 1)
+    {
+        chunksAmount = 1;
+    }
+
+    for (i = 0; i < chunksAmount; i++)
+    {
+        chunks[i].first = (int)((long)recordsAmount * i / chunksAmount);
+        chunks[i].amount = (int)((long)recordsAmount * (i + 1) / chunksAmount) - chunks[i].first;
+        chunks[i].output = output + chunks[i].first * OBJECT_RECORD_LENGTH;
+        chunks[i].icf = icf;
+        chunks[i].instructionImage = instructionImage;
+        chunks[i].dataImage = dataImage;
+    }
+
+    /* the first chunk is formatted by this thread (and so is every chunk that its thread couldn't be created for) */
+    for (i = 1; i < chunksAmount; i++)
+    {
+        isThreadCreated[i] = pthread_create(&threads[i], NULL, formatObjectChunk, &chunks[i]) == 0;
+    }
+
+    formatObjectChunk(&chunks[0]);
+
+    for (i = 1; i < chunksAmount; i++)
+    {
+        if (isThreadCreated[i])
+        {
+            pthread_join(threads[i], NULL);
+        }
+        else
+        {
+            formatObjectChunk(&chunks[i]);
+        }
+    }
+}
+
+/* formats the records of a chunk of the object file (the routine of a formatting thread) */
+void *formatObjectChunk(void *arg)
+{
+    ObjectChunk *chunk = (ObjectChunk *)arg;
+    MemoryImage *instructionImage = chunk->instructionImage;
+    char *output = chunk->output;
+    int amount = chunk->amount;
+    int i;
+
+    /* the code records of the chunk */
+    for (i = chunk->first; i < instructionImage->wordsAmount && amount > 0; i++, amount--)
+    {
+        formatObjectRecord(output, INITIAL_IC + i, instructionImage->words[i] & MASK_24BIT);
+        output += OBJECT_RECORD_LENGTH;
+    }
+
+    /* the data records of the chunk (+ icf because the addresses start at INITIAL_IC) */
+    if (amount > 0)
+    {
+        formatDataRecords(output, INITIAL_DC + chunk->icf, chunk->dataImage, i - instructionImage->wordsAmount, amount);
+    }
+
+    return NULL;
+}
+
+/* formats an amount of records of the data image, after skipping some of them - its words,
+   with the regions expanded between them. the address is the address of the first data record */
+void formatDataRecords(char *output, int address, MemoryImage *dataImage, int skip, int amount)
+{
+    int word = 0; /* the first word of the current run of the words array */
+    int i, j;
+
+    address += skip;
+
+    for (i = 0; i <= dataImage->regionsAmount && amount > 0; i++)
+    {
+        /* the run of words before the region (or all the rest after the last region) */
+        int wordsEnd = i < dataImage->regionsAmount ? dataImage->regions[i].position : dataImage->wordsAmount;
+        int runLength = wordsEnd - word;
+
+        for (j = skip < runLength ? skip : runLength; j < runLength && amount > 0; j++, amount--)
+        {
+            formatObjectRecord(output, address++, dataImage->words[word + j] & MASK_24BIT);
+            output += OBJECT_RECORD_LENGTH;
+        }
+
+        skip = skip > runLength ? skip - runLength : 0;
+        word = wordsEnd;
+
+        if (i < dataImage->regionsAmount)
+        {
+            DataRegion *region = &dataImage->regions[i];
+
+            for (j = skip < region->wordsAmount ? skip : region->wordsAmount; j < region->wordsAmount && amount > 0; j++, amount--)
+            {
+                formatObjectRecord(output, address++, getRegionWord(region, j));
+                output += OBJECT_RECORD_LENGTH;
+            }
+
+            skip = skip > region->wordsAmount ? skip - region->wordsAmount : 0;
+        }
+    }
+}
+
+/* returns a word of a data region, by its index in the region */
+int getRegionWord(DataRegion *region, int index)
+{
+    int code = 0;
+    int i;
+
+    if (region->file == NULL)
+    {
+        return region->value & MASK_24BIT; /* a run of a repeated word */
+    }
+
+    /* the bytes of the file, the first in the highest bits (the last word is padded with zeros) */
+    for (i = 0; i < BYTES_IN_WORD; i++)
+    {
+        int byte = index * BYTES_IN_WORD + i;
+
+        code = (code << (BITS_IN_WORD / BYTES_IN_WORD)) | (byte < region->file->size ? (unsigned char)region->file->data[byte] : 0);
+    }
+
+    return code & MASK_24BIT;
+}
+
+/* creates / wrights to the binary object file (if needed) - the words of the code and the data, packed,
+   the tables of the external and entry symbols and the relocations (the layout is described in binaryObject.h) */
+void writeBinaryObjectFile(int icf, int dcf, char *filename, AssemblerContext *context)
+{
+    unsigned long header[BINARY_HEADER_FIELDS]; /* initialize the numbers of the header */
+    OutputWriter binaryFile;                    /* initialize the writer of the binary object file */
+    ExternalWordNode *external;
+    int externalsAmount = 0;
+    int entriesAmount = 0;
+    int namesSize = 0;
+    int dataWords;
+    int i;
+
+    /* ensure the object file wouldn't be empty */
+    if (icf == INITIAL_IC && dcf == INITIAL_DC)
+    {
+        return;
+    }
+
+    /* the data words (with the regions expanded) */
+    dataWords = context->dataImage.wordsAmount;
+    for (i = 0; i < context->dataImage.regionsAmount; i++)
+    {
+        dataWords += context->dataImage.regions[i].wordsAmount;
+    }
+
+    /* the records of the tables and their names */
+    for (external = context->externalWordHead; external != NULL; external = external->next)
+    {
+        externalsAmount++;
+        namesSize += strlen(external->symbol) + 1;
+    }
+
+    for (i = 0; i < context->symbols->symbolsAmount; i++)
+    {
+        if (context->symbols->symbols[i].isEntry)
+        {
+            entriesAmount++;
+            namesSize += strlen(context->symbols->symbols[i].symbol) + 1;
+        }
+    }
+
+    header[BINARY_VERSION_FIELD] = BINARY_VERSION;
+    header[BINARY_ICF_FIELD] = icf;
+    header[BINARY_DCF_FIELD] = dcf;
+    header[BINARY_CODE_ADDRESS_FIELD] = INITIAL_IC;
+    header[BINARY_CODE_OFFSET_FIELD] = BINARY_HEADER_SIZE;
+    header[BINARY_DATA_OFFSET_FIELD] = BINARY_HEADER_SIZE + context->instructionImage.wordsAmount * BYTES_IN_WORD;
+    header[BINARY_EXTERNALS_OFFSET_FIELD] = ALIGN_TO_NUMBER(header[BINARY_DATA_OFFSET_FIELD] + dataWords * BYTES_IN_WORD);
+    header[BINARY_EXTERNALS_AMOUNT_FIELD] = externalsAmount;
+    header[BINARY_ENTRIES_OFFSET_FIELD] = header[BINARY_EXTERNALS_OFFSET_FIELD] + externalsAmount * BINARY_RECORD_SIZE;
+    header[BINARY_ENTRIES_AMOUNT_FIELD] = entriesAmount;
+    header[BINARY_RELOCATIONS_OFFSET_FIELD] = header[BINARY_ENTRIES_OFFSET_FIELD] + entriesAmount * BINARY_RECORD_SIZE;
+    header[BINARY_RELOCATIONS_AMOUNT_FIELD] = context->relocationsAmount;
+    header[BINARY_NAMES_OFFSET_FIELD] = header[BINARY_RELOCATIONS_OFFSET_FIELD] + context->relocationsAmount * BINARY_NUMBER_SIZE;
+    header[BINARY_NAMES_SIZE_FIELD] = namesSize;
+
+    initializeOutputWriter(&binaryFile);
+    openBinaryObjectFile(filename, &binaryFile.file);
+
+    /* the header */
+    writeText(&binaryFile, BINARY_MAGIC, BINARY_MAGIC_LENGTH);
+    for (i = 0; i < BINARY_HEADER_FIELDS; i++)
+    {
+        writeLittleEndian(&binaryFile, header[i], BINARY_NUMBER_SIZE);
+    }
+
+    /* the code and the data sections, then the padding of the tables */
+    for (i = 0; i < context->instructionImage.wordsAmount; i++)
     {
-        return; /* an error was found opening the file (already printed) */
+        writeLittleEndian(&binaryFile, context->instructionImage.words[i] & MASK_24BIT, BYTES_IN_WORD);
     }
 
-    /* write the 'title' of the file */
-    fprintf(objectFile, "%7d %d\n", icf - INITIAL_IC, dcf);
+    writeBinaryData(&binaryFile, &context->dataImage);
+
+    writeText(&binaryFile, "\0\0\0", header[BINARY_EXTERNALS_OFFSET_FIELD] - header[BINARY_DATA_OFFSET_FIELD] - dataWords * BYTES_IN_WORD);
+
+    /* the externals and the entries tables (the names are in the same order, so each offset is the sum of the names before it) */
+    namesSize = 0;
+    for (external = context->externalWordHead; external != NULL; external = external->next)
+    {
+        writeLittleEndian(&binaryFile, namesSize, BINARY_NUMBER_SIZE);
+        writeLittleEndian(&binaryFile, external->value, BINARY_NUMBER_SIZE);
+        namesSize += strlen(external->symbol) + 1;
+    }
 
-    /* write the instruction code first */
-    while (instructionHead != NULL)
+    /* the newest entries come first (as in the entry file) */
+    for (i = context->symbols->symbolsAmount - 1; i >= 0; i--)
     {
-        fprintf(objectFile, "%07d %06x\n", instructionHead->value, instructionHead->code & MASK_24BIT);
-        instructionHead = instructionHead->next;
+        Symbol *symbol = &context->symbols->symbols[i];
+
+        if (symbol->isEntry)
+        {
+            writeLittleEndian(&binaryFile, namesSize, BINARY_NUMBER_SIZE);
+            writeLittleEndian(&binaryFile, symbol->value, BINARY_NUMBER_SIZE);
+            namesSize += strlen(symbol->symbol) + 1;
+        }
     }
 
-    /* now write the data code */
-    while (dataHead != NULL)
+    /* the relocations table */
+    for (i = 0; i < context->relocationsAmount; i++)
     {
-        /* + icf because the addresses start at INITIAL_IC */
-        fprintf(objectFile, "%07d %06x\n", dataHead->value + icf, dataHead->code & MASK_24BIT);
-        dataHead = dataHead->next;
+        writeLittleEndian(&binaryFile, context->relocations[i], BINARY_NUMBER_SIZE);
     }
 
-    fclose(objectFile); /* close the file */
+    /* the names (with their null-terminators) */
+    for (external = context->externalWordHead; external != NULL; external = external->next)
+    {
+        writeText(&binaryFile, external->symbol, strlen(external->symbol) + 1);
+    }
+
+    for (i = context->symbols->symbolsAmount - 1; i >= 0; i--)
+    {
+        if (context->symbols->symbols[i].isEntry)
+        {
+            writeText(&binaryFile, context->symbols->symbols[i].symbol, strlen(context->symbols->symbols[i].symbol) + 1);
+        }
+    }
+
+    closeOutputWriter(&binaryFile); /* close the file */
+}
+
+/* writes the words of the data image to the binary object file - its words, with the regions expanded between them */
+void writeBinaryData(OutputWriter *binaryFile, MemoryImage *dataImage)
+{
+    int word = 0; /* the next word of the words array */
+    int i, j;
+
+    for (i = 0; i <= dataImage->regionsAmount; i++)
+    {
+        /* the words before the region (or all the rest after the last region) */
+        int wordsEnd = i < dataImage->regionsAmount ? dataImage->regions[i].position : dataImage->wordsAmount;
+
+        for (; word < wordsEnd; word++)
+        {
+            writeLittleEndian(binaryFile, dataImage->words[word] & MASK_24BIT, BYTES_IN_WORD);
+        }
+
+        if (i < dataImage->regionsAmount)
+        {
+            for (j = 0; j < dataImage->regions[i].wordsAmount; j++)
+            {
+                writeLittleEndian(binaryFile, getRegionWord(&dataImage->regions[i], j), BYTES_IN_WORD);
+            }
+        }
+    }
+}
+
+/* creates / wrights to the relocation file (if needed) - the address of every word that holds an address of
+   this file (R flag), so a loader can move the program with a single pass over them */
+void writeRelocationFile(char *filename, int *relocations, int relocationsAmount)
+{
+    OutputWriter relocationFile; /* initialize the writer of the relocation file */
+    int i;
+
+    /* if there are no relocatable words, dont create the file */
+    if (relocationsAmount == 0)
+    {
+        return;
+    }
+
+    initializeOutputWriter(&relocationFile);
+    openRelocationFile(filename, &relocationFile.file); /* prepare the file */
+
+    for (i = 0; i < relocationsAmount; i++)
+    {
+        writeDecimal(&relocationFile, relocations[i], ADDRESS_DIGITS, '0');
+        writeText(&relocationFile, "\n", 1);
+    }
+
+    closeOutputWriter(&relocationFile); /* close the file */
 }
 
 /* creates / wrights to the external file (if needed) */
 void writeExternalFile(char *filename, ExternalWordNode *head)
 {
-    FILE *externalFile;
+    OutputWriter externalFile; /* initialize the writer of the external file */
 
     /* if the external list is empty, dont create the file */
     if (head == NULL)
@@ -50,49 +400,47 @@ void writeExternalFile(char *filename, ExternalWordNode *head)
         return;
     }
 
-    externalFile = openExternFile(filename); /* open / create the file */
-
-    if (externalFile == NULL)
-    {
-        return; /* an error was found opening the file (already printed) */
-    }
+    initializeOutputWriter(&externalFile);
+    openExternFile(filename, &externalFile.file); /* prepare the file */
 
     while (head != NULL)
     {
-        fprintf(externalFile, "%s %07d\n", head->symbol, head->value);
+        writeSymbolRecord(&externalFile, head->symbol, head->value);
         head = head->next;
     }
 
-    fclose(externalFile); /* close the file */
+    closeOutputWriter(&externalFile); /* close the file */
 }
 
 /* creates / wrights to the entry file (if needed) */
-void writeEntryFile(char *filename, SymbolNode *head)
+void writeEntryFile(char *filename, SymbolTable *table)
 {
-    FILE *entryFile = NULL; /* initialize the object file */
+    OutputWriter entryFile; /* initialize the writer of the entry file */
+    int isOpen = FALSE;     /* flag if the file was prepared */
+    int i;
 
-    while (head != NULL)
+    /* the newest symbols are written first */
+    for (i = table->symbolsAmount - 1; i >= 0; i--)
     {
+        Symbol *symbol = &table->symbols[i];
+
         /* only print the entry symbols */
-        if (head->isEntry)
+        if (symbol->isEntry)
         {
-            /* if its the first entry, create the file (avoid creating when uneccesary) */
-            if (entryFile == NULL)
+            /* if its the first entry, prepare the file (avoid creating when uneccesary) */
+            if (!isOpen)
             {
-                entryFile = openEntryFile(filename);
-                if (entryFile == NULL)
-                {
-                    return; /* an error was found opening the file (already printed) */
-                }
+                initializeOutputWriter(&entryFile);
+                openEntryFile(filename, &entryFile.file);
+                isOpen = TRUE;
             }
 
-            fprintf(entryFile, "%s %07d\n", head->symbol, head->value);
+            writeSymbolRecord(&entryFile, symbol->symbol, symbol->value);
         }
-        head = head->next;
     }
 
-    if (entryFile != NULL)
+    if (isOpen)
     {
-        fclose(entryFile); /* close the file */
+        closeOutputWriter(&entryFile); /* close the file */
     }
 }
\ No newline at end of file